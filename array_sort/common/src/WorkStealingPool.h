@@ -0,0 +1,158 @@
+// C++
+// 並列ソートの共通部品: ワークスティーリング方式のスレッドプール
+//
+// マージソートとクイックソートの並列版、およびソートのベンチマークで共有します。
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 並列に実行するタスクのまとまり。wait() で、まとまりのすべてのタスクの終了を待ちます。
+struct TaskGroup {
+    std::atomic<long> pending{0};
+};
+
+// ワークスティーリング方式のスレッドプールです。
+// ワーカーごとにタスクの両端キューを持ち、タスクを追加したスレッドのキューの末尾に積みます。
+// 各ワーカーは自分のキューの末尾から取り出し (直前に分割した、キャッシュに残っている小さい問題)、
+// 空になったら他のワーカーのキューの先頭から盗みます (分割の早い段階の大きい問題)。
+// プールのワーカー以外のスレッドは 0 番のキューを使い、wait() の間はワーカーとしてタスクを実行します。
+class WorkStealingPool {
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> _queues;
+    std::vector<std::thread> _threads;
+    std::atomic<long> _queued;
+    std::atomic<bool> _stop;
+    std::mutex _sleep_mutex;
+    std::condition_variable _sleep_cv;
+
+    // 実行中のスレッドが属するプールと、そのワーカー番号
+    static std::pair<const WorkStealingPool*, unsigned int>& _thread_slot() {
+        static thread_local std::pair<const WorkStealingPool*, unsigned int> slot(nullptr, 0);
+        return slot;
+    }
+
+    unsigned int _current_index() const {
+        const auto& slot = _thread_slot();
+        return slot.first == this ? slot.second : 0;
+    }
+
+    // 自分のキューの末尾か、他のキューの先頭からタスクを1つ取り出して実行します。
+    bool _run_one(unsigned int index) {
+        std::function<void()> task;
+        {
+            WorkerQueue& own = *_queues[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+            }
+        }
+        for (size_t k = 1; !task && k < _queues.size(); ++k) {
+            WorkerQueue& victim = *_queues[(index + k) % _queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+            }
+        }
+        if (!task) {
+            return false;
+        }
+        --_queued;
+        task();
+        return true;
+    }
+
+    void _worker_loop(unsigned int index) {
+        _thread_slot() = std::make_pair(this, index);
+        while (true) {
+            if (_run_one(index)) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(_sleep_mutex);
+            _sleep_cv.wait(lock, [this] { return _stop.load() || _queued.load() > 0; });
+            if (_stop.load() && _queued.load() == 0) {
+                return;
+            }
+        }
+    }
+
+public:
+    // 呼び出し元のスレッドを含めて num_threads 個 (0 の場合はハードウェアの並列数) のスレッドで実行します。
+    explicit WorkStealingPool(unsigned int num_threads = 0) : _queued(0), _stop(false) {
+        if (num_threads == 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned int i = 0; i < num_threads; ++i) {
+            _queues.emplace_back(new WorkerQueue());
+        }
+        for (unsigned int i = 1; i < num_threads; ++i) {
+            _threads.emplace_back(&WorkStealingPool::_worker_loop, this, i);
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+            _stop = true;
+        }
+        _sleep_cv.notify_all();
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned int size() const {
+        return static_cast<unsigned int>(_queues.size());
+    }
+
+    // task を group のタスクとして追加します。
+    template <typename Task>
+    void spawn(TaskGroup& group, Task task) {
+        ++group.pending;
+        WorkerQueue& queue = *_queues[_current_index()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.emplace_back([&group, task]() mutable {
+                task();
+                --group.pending;
+            });
+        }
+        {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+            ++_queued;
+        }
+        _sleep_cv.notify_one();
+    }
+
+    // group のタスクがすべて終わるまで、待つ代わりにプールのタスクを実行します。
+    void wait(TaskGroup& group) {
+        unsigned int index = _current_index();
+        while (group.pending.load() > 0) {
+            if (!_run_one(index)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,392 @@
+// C++
+// 安定な比較ソートの共通部品: ボトムアップのマージソートと、入力のランを生かす適応的マージソート (powersort)
+//
+// マージソートのデモが参照実装で、基数ソートはキーが基数ソートで扱えない型のときにこのマージソートを使います。
+// 射影付きの比較 (IdentityProjection・ProjectedLess) と挿入ソートは、クイックソートのデモも使います。
+
+#ifndef ADAPTIVE_MERGE_SORT_H
+#define ADAPTIVE_MERGE_SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../sort_network/src/SortingNetwork.h"
+
+// 最初に挿入ソートで作る整列済みの区間 (ラン) の長さ
+const size_t MERGE_RUN_SIZE = 32;
+
+// 要素そのものを並べ替えのキーにする射影
+struct IdentityProjection {
+    template <typename T>
+    const T& operator()(const T& value) const {
+        return value;
+    }
+};
+
+// 要素を projection でキーに写し、キーを compare で比べる比較です。
+// projection にはメンバーへのポインター (&Record::key など) も使えます。
+template <typename Compare, typename Projection>
+struct ProjectedLess {
+    Compare compare;
+    Projection projection;
+
+    template <typename T>
+    bool operator()(const T& a, const T& b) const {
+        return compare(std::invoke(projection, a), std::invoke(projection, b));
+    }
+};
+
+// int を昇順に並べる比較か (SIMD のソーティングネットワークを使えるか) をコンパイル時に判定します。
+template <typename Less>
+struct is_ascending_int_less : std::false_type {};
+template <>
+struct is_ascending_int_less<std::less<>> : std::true_type {};
+template <>
+struct is_ascending_int_less<std::less<int>> : std::true_type {};
+template <typename Compare>
+struct is_ascending_int_less<ProjectedLess<Compare, IdentityProjection>> : is_ascending_int_less<Compare> {};
+
+// 整列済みの [left, left + left_size) と [right, right + right_size) を output に安定にマージします。
+// 等しい要素は left の要素を先に置きます。
+template <typename T, typename Less>
+void merge_runs(const T* left, size_t left_size, const T* right, size_t right_size, T* output, Less less) {
+    size_t i = 0;
+    size_t j = 0;
+    while (i < left_size && j < right_size) {
+        if (less(right[j], left[i])) {
+            *output++ = right[j++];
+        } else {
+            *output++ = left[i++];
+        }
+    }
+    output = std::copy(left + i, left + left_size, output);
+    std::copy(right + j, right + right_size, output);
+}
+
+// [first, last) を挿入ソートで安定に並べ替えます。
+template <typename T, typename Less>
+void insertion_sort(T* first, T* last, Less less) {
+    for (T* i = first + 1; i < last; ++i) {
+        T value = std::move(*i);
+        T* j = i;
+        while (j > first && less(value, *(j - 1))) {
+            *j = std::move(*(j - 1));
+            --j;
+        }
+        *j = std::move(value);
+    }
+}
+
+// [data, data + size) の run_size 個ずつの整列済みのランを、同じ大きさの buffer を作業領域にして
+// 幅を倍にしながらボトムアップにマージします (merge_sort_range や、ソーティングネットワークで並べたランのマージに使います)。
+// 前のランの末尾が後のランの先頭以下なら、比較せずにそのままコピーします。
+template <typename T, typename Less>
+void merge_sorted_runs(T* data, T* buffer, size_t size, size_t run_size, Less less) {
+    T* source = data;
+    T* destination = buffer;
+    for (size_t width = run_size; width < size; width *= 2) {
+        for (size_t start = 0; start < size; start += 2 * width) {
+            size_t mid = std::min(start + width, size);
+            size_t end = std::min(start + 2 * width, size);
+            if (mid == end || !less(source[mid], source[mid - 1])) {
+                std::copy(source + start, source + end, destination + start);
+            } else {
+                merge_runs(source + start, mid - start, source + mid, end - mid, destination + start, less);
+            }
+        }
+        std::swap(source, destination);
+    }
+    if (source != data) {
+        std::copy(source, source + size, data);
+    }
+}
+
+// [data, data + size) を、同じ大きさの buffer だけを作業領域にしてボトムアップのマージソートで安定に並べ替えます。
+// MERGE_RUN_SIZE 個ずつを挿入ソートで (int を昇順に並べるときに SIMD のソーティングネットワークが使える CPU では
+// SORT_NETWORK_MAX_SIZE 個ずつをネットワークで) 並べてから、隣り合うランを幅を倍にしながらマージします。
+// ネットワークは等しい要素の順序を保ちませんが、int では等しい要素は区別できないため結果は同じです。
+// 各パスは data と buffer の一方から他方へ書き込み、次のパスで読み書きの向きを入れ替えるため、
+// 再帰もパスごとの書き戻しもありません。
+template <typename T, typename Less>
+void merge_sort_range(T* data, T* buffer, size_t size, Less less) {
+    if (size <= 1) {
+        return;
+    }
+    bool use_network = false;
+    if constexpr (std::is_same<T, int>::value && is_ascending_int_less<Less>::value) {
+        use_network = sort_network_kernel().vectorized;
+    }
+    const size_t run_size = use_network ? SORT_NETWORK_MAX_SIZE : MERGE_RUN_SIZE;
+    for (size_t start = 0; start < size; start += run_size) {
+        size_t run_end = std::min(start + run_size, size);
+        if constexpr (std::is_same<T, int>::value && is_ascending_int_less<Less>::value) {
+            if (use_network) {
+                network_sort(data + start, run_end - start);
+                continue;
+            }
+        }
+        insertion_sort(data + start, data + run_end, less);
+    }
+
+    merge_sorted_runs(data, buffer, size, run_size, less);
+}
+
+// a[0], ..., a[size - 1] のうち、先頭から pred を満たす要素の数を返します (pred は先頭側で true、末尾側で false)。
+// 1, 2, 4, ... 個先を調べる指数探索で範囲を絞ってから二分探索するため、答えが小さいほど速く終わります。
+template <typename T, typename Pred>
+size_t gallop_forward(const T* a, size_t size, Pred pred) {
+    size_t bound = 1;
+    while (bound <= size && pred(a[bound - 1])) {
+        bound *= 2;
+    }
+    size_t low = bound / 2;
+    size_t high = std::min(bound, size);
+    return std::partition_point(a + low, a + high, pred) - a;
+}
+
+// a[0], ..., a[size - 1] のうち、末尾から pred を満たす要素の数を返します (pred は先頭側で false、末尾側で true)。
+template <typename T, typename Pred>
+size_t gallop_backward(const T* a, size_t size, Pred pred) {
+    size_t bound = 1;
+    while (bound <= size && pred(a[size - bound])) {
+        bound *= 2;
+    }
+    size_t low = bound / 2;
+    size_t high = std::min(bound, size);
+    const T* boundary = std::partition_point(a + (size - high), a + (size - low),
+                                             [&pred](const T& value) { return !pred(value); });
+    return (a + size) - boundary;
+}
+
+// 適応的マージソートのマージの状態
+template <typename T>
+struct AdaptiveMergeState {
+    // マージで短い側のランを退避する作業領域 (必要になったときだけ広げる)
+    std::vector<T> buffer;
+    // 同じ側が続けてこの回数勝ったらギャロップに切り替える。ギャロップが効くと減り、効かないと増える
+    size_t min_gallop;
+};
+
+// 同じ側が続けて勝った回数の初期値
+const size_t MIN_GALLOP = 7;
+
+// 隣り合う整列済みのラン [lo, mid) と [mid, hi) を安定にマージします。
+// 前のランの先頭のうち後のランの先頭以下の要素と、後のランの末尾のうち前のランの末尾以上の要素は
+// 既に正しい位置にあるため、ギャロップで見つけて除いてから、短い側だけを作業領域に退避してマージします。
+// マージ中に同じ側が min_gallop 回続けて勝ったら、1つずつ比べる代わりにギャロップでまとめて移します。
+template <typename T, typename Less>
+void merge_adjacent_runs(AdaptiveMergeState<T>& state, T* data, size_t lo, size_t mid, size_t hi, Less less) {
+    const T& first_right = data[mid];
+    lo += gallop_forward(data + lo, mid - lo, [&](const T& value) { return !less(first_right, value); });
+    if (lo == mid) {
+        return;
+    }
+    const T& last_left = data[mid - 1];
+    hi -= gallop_backward(data + mid, hi - mid, [&](const T& value) { return !less(value, last_left); });
+
+    size_t left_size = mid - lo;
+    size_t right_size = hi - mid;
+    // 作業領域には退避する要素をムーブして作るため、要素の型にデフォルトコンストラクターは要りません
+    // (clear() しても確保済みの容量は残るため、マージのたびに確保し直すことはありません)
+    state.buffer.clear();
+
+    if (left_size <= right_size) {
+        // 前のランを退避し、先頭から順に書き込む
+        state.buffer.insert(state.buffer.end(), std::make_move_iterator(data + lo), std::make_move_iterator(data + mid));
+        T* a = state.buffer.data();
+        T* a_end = a + left_size;
+        T* b = data + mid;
+        T* b_end = data + hi;
+        T* output = data + lo;
+        while (a < a_end && b < b_end) {
+            size_t a_wins = 0;
+            size_t b_wins = 0;
+            while (a < a_end && b < b_end && a_wins < state.min_gallop && b_wins < state.min_gallop) {
+                if (less(*b, *a)) {
+                    *output++ = std::move(*b++);
+                    ++b_wins;
+                    a_wins = 0;
+                } else {
+                    *output++ = std::move(*a++);
+                    ++a_wins;
+                    b_wins = 0;
+                }
+            }
+            while (a < a_end && b < b_end) {
+                const T& b_value = *b;
+                size_t a_count = gallop_forward(a, a_end - a, [&](const T& value) { return !less(b_value, value); });
+                output = std::move(a, a + a_count, output);
+                a += a_count;
+                if (a == a_end) {
+                    break;
+                }
+                *output++ = std::move(*b++);
+                if (b == b_end) {
+                    break;
+                }
+                const T& a_value = *a;
+                size_t b_count = gallop_forward(b, b_end - b, [&](const T& value) { return less(value, a_value); });
+                output = std::move(b, b + b_count, output);
+                b += b_count;
+                if (b == b_end) {
+                    break;
+                }
+                *output++ = std::move(*a++);
+                if (a_count < MIN_GALLOP && b_count < MIN_GALLOP) {
+                    ++state.min_gallop;
+                    break;
+                }
+                if (state.min_gallop > 1) {
+                    --state.min_gallop;
+                }
+            }
+        }
+        std::move(a, a_end, output);
+    } else {
+        // 後のランを退避し、末尾から順に書き込む
+        state.buffer.insert(state.buffer.end(), std::make_move_iterator(data + mid), std::make_move_iterator(data + hi));
+        T* a_begin = data + lo;
+        T* a = data + mid;
+        T* b_begin = state.buffer.data();
+        T* b = b_begin + right_size;
+        T* output = data + hi;
+        while (a > a_begin && b > b_begin) {
+            size_t a_wins = 0;
+            size_t b_wins = 0;
+            while (a > a_begin && b > b_begin && a_wins < state.min_gallop && b_wins < state.min_gallop) {
+                if (less(*(b - 1), *(a - 1))) {
+                    *--output = std::move(*--a);
+                    ++a_wins;
+                    b_wins = 0;
+                } else {
+                    *--output = std::move(*--b);
+                    ++b_wins;
+                    a_wins = 0;
+                }
+            }
+            while (a > a_begin && b > b_begin) {
+                const T& b_value = *(b - 1);
+                size_t a_count = gallop_backward(a_begin, a - a_begin, [&](const T& value) { return less(b_value, value); });
+                a -= a_count;
+                output -= a_count;
+                std::move_backward(a, a + a_count, output + a_count);
+                if (a == a_begin) {
+                    break;
+                }
+                *--output = std::move(*--b);
+                if (b == b_begin) {
+                    break;
+                }
+                const T& a_value = *(a - 1);
+                size_t b_count = gallop_backward(b_begin, b - b_begin, [&](const T& value) { return !less(value, a_value); });
+                b -= b_count;
+                output -= b_count;
+                std::move(b, b + b_count, output);
+                if (b == b_begin) {
+                    break;
+                }
+                *--output = std::move(*--a);
+                if (a_count < MIN_GALLOP && b_count < MIN_GALLOP) {
+                    ++state.min_gallop;
+                    break;
+                }
+                if (state.min_gallop > 1) {
+                    --state.min_gallop;
+                }
+            }
+        }
+        std::move(b_begin, b, a_begin);
+    }
+}
+
+// data[start] から始まるランの終わりを返します。狭義の降順のランは反転して昇順にします
+// (等しい要素を含む降順を反転すると安定でなくなるため、狭義に限ります)。
+// ランが MERGE_RUN_SIZE より短ければ、挿入ソートで MERGE_RUN_SIZE 個まで伸ばします。
+template <typename T, typename Less>
+size_t extend_run(T* data, size_t start, size_t size, Less less) {
+    size_t end = start + 1;
+    if (end < size) {
+        if (less(data[end], data[start])) {
+            while (end < size && less(data[end], data[end - 1])) {
+                ++end;
+            }
+            std::reverse(data + start, data + end);
+        } else {
+            while (end < size && !less(data[end], data[end - 1])) {
+                ++end;
+            }
+        }
+    }
+    if (end - start < MERGE_RUN_SIZE) {
+        end = std::min(start + MERGE_RUN_SIZE, size);
+        insertion_sort(data + start, data + end, less);
+    }
+    return end;
+}
+
+// powersort のマージの順番を決める値です。隣り合うラン [start, start + left_size) と
+// [start + left_size, start + left_size + right_size) の中点を配列全体に対する [0, 1) の2進小数で表したとき、
+// 上から何ビット目で初めて異なるかを返します。値が大きいほど、完全二分木の深い (小さい) マージに当たります。
+inline int node_power(size_t start, size_t left_size, size_t right_size, size_t size) {
+    size_t a = 2 * start + left_size;
+    size_t b = a + left_size + right_size;
+    int power = 0;
+    while (true) {
+        ++power;
+        if (a >= size) {
+            a -= size;
+            b -= size;
+        } else if (b >= size) {
+            break;
+        }
+        a <<= 1;
+        b <<= 1;
+    }
+    return power;
+}
+
+// [data, data + size) を、入力に既にある昇順・降順のランを生かす適応的マージソート (powersort) で安定に並べ替えます。
+// ランを左から順に見つけ、隣のランとの境界の node_power がスタックの上の境界より小さい間、スタックの上のランとマージします。
+// マージの順番はランの長さに応じた最適に近い二分木になり、ほぼ整列済みの入力はほぼ線形時間で並べ替わります。
+template <typename T, typename Less = std::less<>>
+void adaptive_merge_sort(T* data, size_t size, Less less = Less()) {
+    if (size <= 1) {
+        return;
+    }
+    struct Run {
+        size_t start;
+        // このランと次のランとの境界の node_power
+        int power;
+    };
+    // node_power はスタックの下から上へ狭義に増えるため、高さは size_t のビット数 + 1 を超えない
+    Run stack[sizeof(size_t) * 8 + 1];
+    size_t height = 0;
+    AdaptiveMergeState<T> state = {std::vector<T>(), MIN_GALLOP};
+
+    size_t start = 0;
+    size_t end = extend_run(data, 0, size, less);
+    while (end < size) {
+        size_t next_end = extend_run(data, end, size, less);
+        int power = node_power(start, end - start, next_end - end, size);
+        while (height > 0 && stack[height - 1].power > power) {
+            --height;
+            merge_adjacent_runs(state, data, stack[height].start, start, end, less);
+            start = stack[height].start;
+        }
+        stack[height++] = Run{start, power};
+        start = end;
+        end = next_end;
+    }
+    while (height > 0) {
+        --height;
+        merge_adjacent_runs(state, data, stack[height].start, start, end, less);
+        start = stack[height].start;
+    }
+}
+
+#endif
@@ -3,75 +3,166 @@
 
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include <string>
+#include <thread>
+#include <random>
+#include <cstddef>
+#include <limits>
 
-class ArrayData {
-private:
-    std::vector<int> _data;
+#include "../../common/src/WorkStealingPool.h"
+#include "AdaptiveMergeSort.h"
+#include "../../sort_radix/src/RadixSort.h"
+
+// 並列ソートで、これより長い区間だけを別のタスクに分ける
+const size_t PARALLEL_SORT_GRAIN = 1 << 14;
+// 並列マージで、出力がこれより長いときだけ2つに分ける
+const size_t PARALLEL_MERGE_GRAIN = 1 << 15;
 
-    std::vector<int> _merge_sort(const std::vector<int>& target) {
-        // 配列の長さが1以下の場合はそのまま返す（基本ケース）
-        if (target.size() <= 1) {
-            return target;
+// 2つの整列済みの列を安定にマージしたとき、出力の先頭 k 要素に left から入る要素の数 (co-rank) を二分探索で求めます。
+// 出力を k の位置で切れば、前後の部分を独立にマージできます。
+template <typename T, typename Less>
+size_t co_rank(size_t k, const T* left, size_t left_size, const T* right, size_t right_size, Less less) {
+    size_t low = k > right_size ? k - right_size : 0;
+    size_t high = std::min(k, left_size);
+    while (low < high) {
+        size_t i = low + (high - low) / 2;
+        size_t j = k - i;
+        // right[j - 1] が left[i] より小さくなければ、left[i] も先頭 k 要素に入る
+        if (j > 0 && i < left_size && !less(right[j - 1], left[i])) {
+            low = i + 1;
+        } else {
+            high = i;
         }
-        
-        // 配列を半分に分割
-        size_t mid = target.size() / 2;
-        std::vector<int> left_half(target.begin(), target.begin() + mid);
-        std::vector<int> right_half(target.begin() + mid, target.end());
-        
-        // 左右の半分を再帰的にソート
-        left_half = _merge_sort(left_half);
-        right_half = _merge_sort(right_half);
-        
-        // ソート済みの半分同士をマージ
-        return _merge(left_half, right_half);
     }
+    return low;
+}
 
-    std::vector<int> _merge(const std::vector<int>& left, const std::vector<int>& right) {
-        std::vector<int> result;
-        size_t i = 0, j = 0;
-        
-        // 左右の配列を比較しながらマージ
-        while (i < left.size() && j < right.size()) {
-            if (left[i] <= right[j]) {
-                result.push_back(left[i]);
-                i++;
-            } else {
-                result.push_back(right[j]);
-                j++;
-            }
-        }
-        
-        // 残った要素を追加
-        while (i < left.size()) {
-            result.push_back(left[i]);
-            i++;
-        }
-        
-        while (j < right.size()) {
-            result.push_back(right[j]);
-            j++;
+// 出力を co-rank で半分に分け、前後を並列にマージします。
+template <typename T, typename Less>
+void parallel_merge(WorkStealingPool& pool, const T* left, size_t left_size,
+                    const T* right, size_t right_size, T* output, Less less) {
+    size_t size = left_size + right_size;
+    if (size <= PARALLEL_MERGE_GRAIN) {
+        merge_runs(left, left_size, right, right_size, output, less);
+        return;
+    }
+    size_t k = size / 2;
+    size_t i = co_rank(k, left, left_size, right, right_size, less);
+    size_t j = k - i;
+    TaskGroup group;
+    pool.spawn(group, [&pool, left, i, right, j, output, less]() {
+        parallel_merge(pool, left, i, right, j, output, less);
+    });
+    parallel_merge(pool, left + i, left_size - i, right + j, right_size - j, output + k, less);
+    pool.wait(group);
+}
+
+// [data, data + size) を並べ替え、to_buffer が true なら結果を buffer に、false なら data に置きます。
+// 前半と後半を並列に「反対側の配列へ」並べ替えてから、並列マージで目的の配列へ書き込むため、コピーは要りません。
+template <typename T, typename Less>
+void parallel_merge_sort_task(WorkStealingPool& pool, T* data, T* buffer, size_t size, bool to_buffer, Less less) {
+    if (size <= PARALLEL_SORT_GRAIN) {
+        merge_sort_range(data, buffer, size, less);
+        if (to_buffer) {
+            std::copy(data, data + size, buffer);
         }
-        
-        return result;
+        return;
     }
+    size_t mid = size / 2;
+    TaskGroup group;
+    pool.spawn(group, [&pool, data, buffer, mid, to_buffer, less]() {
+        parallel_merge_sort_task(pool, data, buffer, mid, !to_buffer, less);
+    });
+    parallel_merge_sort_task(pool, data + mid, buffer + mid, size - mid, !to_buffer, less);
+    pool.wait(group);
+
+    const T* source = to_buffer ? data : buffer;
+    T* destination = to_buffer ? buffer : data;
+    parallel_merge(pool, source, mid, source + mid, size - mid, destination, less);
+}
+
+// [data, data + size) を num_threads 個 (0 の場合はハードウェアの並列数) のスレッドで less の順に安定に並べ替えます。
+template <typename T, typename Less = std::less<>>
+void parallel_merge_sort(T* data, size_t size, unsigned int num_threads = 0, Less less = Less()) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // 作業領域は基数ソートと同じく要素を作らずに確保するため、要素の型にデフォルトコンストラクターは要りません。
+    // マージは作業領域の要素へ代入するため、memcpy でコピーできない型だけは data をコピーして要素を作っておきます。
+    RadixBuffer<T> buffer(size);
+    if constexpr (!std::is_trivially_copyable<T>::value) {
+        std::uninitialized_copy(data, data + size, buffer.data());
+        buffer.set_constructed();
+    }
+    if (num_threads == 1 || size <= PARALLEL_SORT_GRAIN) {
+        merge_sort_range(data, buffer.data(), size, less);
+        return;
+    }
+    WorkStealingPool pool(num_threads);
+    parallel_merge_sort_task(pool, data, buffer.data(), size, false, less);
+}
+
+// 要素の型 T の配列を、要素を projection で写したキーの compare の順に安定に並べ替えます。
+// キーが整数か float/double で、compare が std::less (昇順) か std::greater (降順) のときは基数ソートを、
+// それ以外のときはマージソートを、コンパイル時に選びます。
+// 例えば BasicArrayData<Record, std::greater<>, int Record::*> は、Record を key の降順に、
+// key が等しいレコードは元の順序のまま並べ替えます。
+template <typename T = int, typename Compare = std::less<>, typename Projection = IdentityProjection>
+class BasicArrayData {
+private:
+    typedef RadixDispatch<T, Compare, Projection> Dispatch;
+
+    std::vector<T> _data;
+    ProjectedLess<Compare, Projection> _less;
 
 public:
-    std::vector<int> get() {
+    BasicArrayData(Compare compare = Compare(), Projection projection = Projection())
+        : _less{compare, projection} {}
+
+    std::vector<T> get() {
         return _data;
     }
 
-    bool set(const std::vector<int>& data) {
+    bool set(const std::vector<T>& data) {
         _data = data;
         return true;
     }
 
     bool sort() {
-        _data = _merge_sort(_data);
+        if constexpr (Dispatch::supported) {
+            radix_sort(_data.data(), _data.size(), 1, _less.projection, Dispatch::descending);
+        } else {
+            adaptive_merge_sort(_data.data(), _data.size(), _less);
+        }
+        return true;
+    }
+
+    // num_threads 個 (0 の場合はハードウェアの並列数) のスレッドで並べ替えます。
+    bool parallel_sort(unsigned int num_threads = 0) {
+        if constexpr (Dispatch::supported) {
+            radix_sort(_data.data(), _data.size(), num_threads, _less.projection, Dispatch::descending);
+        } else {
+            parallel_merge_sort(_data.data(), _data.size(), num_threads, _less);
+        }
         return true;
     }
 };
 
+typedef BasicArrayData<int> ArrayData;
+
+// キーを持つレコード (BasicArrayData の例で使います)。
+// デフォルトコンストラクターを持たない型でも並べ替えられることを確かめるため、コンストラクターを定義します。
+struct Record {
+    std::string name;
+    int key;
+
+    Record(std::string name, int key) : name(std::move(name)), key(key) {}
+};
+
 void printVector(const std::vector<int>& vec) {
     std::cout << "  [";
     for (size_t i = 0; i < vec.size(); ++i) {
@@ -138,6 +229,39 @@ int main() {
     std::cout << "  ソート後: ";
     printVector(array_data.get());
 
+    // 大きな配列を並列に並べ替える
+    std::cout << "\nparallel_sort" << std::endl;
+    std::mt19937 rng(1);
+    std::vector<int> input6(1000000);
+    for (int& value : input6) {
+        value = static_cast<int>(rng() % 1000000);
+    }
+    array_data.set(input6);
+    array_data.parallel_sort();
+    std::vector<int> sorted6 = array_data.get();
+    std::cout << "  要素数: " << sorted6.size() << std::endl;
+    std::cout << "  先頭の5要素: ";
+    printVector(std::vector<int>(sorted6.begin(), sorted6.begin() + 5));
+    std::cout << "  昇順に並んでいるか: " << (std::is_sorted(sorted6.begin(), sorted6.end()) ? "true" : "false") << std::endl;
+
+    // レコードを、int の配列に写さずにメンバー key の降順で並べ替える (key が等しいレコードは元の順序のまま)
+    std::cout << "\nsort (Record, key の降順)" << std::endl;
+    BasicArrayData<Record, std::greater<>, int Record::*> record_data(std::greater<>(), &Record::key);
+    record_data.set({{"alice", 72}, {"bob", 95}, {"carol", 60}, {"dave", 88}, {"eve", 95}});
+    record_data.sort();
+    for (const Record& record : record_data.get()) {
+        std::cout << "  " << record.name << ": " << record.key << std::endl;
+    }
+
+    // キーが文字列のときは基数ソートを使えないため、並列マージソートで name の昇順に並べ替える
+    std::cout << "\nparallel_sort (Record, name の昇順)" << std::endl;
+    BasicArrayData<Record, std::less<>, std::string Record::*> name_data(std::less<>(), &Record::name);
+    name_data.set({{"dave", 88}, {"bob", 95}, {"eve", 95}, {"alice", 72}, {"carol", 60}});
+    name_data.parallel_sort();
+    for (const Record& record : name_data.get()) {
+        std::cout << "  " << record.name << ": " << record.key << std::endl;
+    }
+
     std::cout << "\nMergeSort TEST <----- end" << std::endl;
     
     return 0;
@@ -0,0 +1,204 @@
+// C++
+// ソーティングネットワーク (バイトニックソート) の共通部品: スカラー版と SIMD 版 (AVX2, AVX-512) の実装と、実行時の選択
+//
+// ソーティングネットワークのデモが参照実装で、マージソートとクイックソートは短い区間の並べ替えに使います。
+// 複数の翻訳単位から取り込めるよう、関数はすべて inline にしています。
+
+#ifndef SORTING_NETWORK_H
+#define SORTING_NETWORK_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SORT_NETWORK_X86 1
+#else
+#define SORT_NETWORK_X86 0
+#endif
+
+// ソーティングネットワークで並べ替える配列の最大の長さ
+const size_t SORT_NETWORK_MAX_SIZE = 256;
+
+// バイトニックソートのネットワークで data[0], ..., data[n - 1] を昇順に並べ替えます (n は 8 以上 256 以下の2のべき乗)。
+// 比較と交換の組は値によらず固定なので、分岐せずに min/max だけで並べ替えます。
+// 以下の SIMD 版は同じネットワークを 8/16 要素ずつまとめて計算するため、結果はこの関数と一致します。
+inline void sort_network_scalar(int* data, size_t n) {
+    for (size_t k = 2; k <= n; k *= 2) {
+        for (size_t j = k / 2; j > 0; j /= 2) {
+            for (size_t i = 0; i < n; ++i) {
+                size_t partner = i ^ j;
+                if (partner > i) {
+                    int low = std::min(data[i], data[partner]);
+                    int high = std::max(data[i], data[partner]);
+                    bool ascending = (i & k) == 0;
+                    data[i] = ascending ? low : high;
+                    data[partner] = ascending ? high : low;
+                }
+            }
+        }
+    }
+}
+
+#if SORT_NETWORK_X86
+// AVX2 版: 8要素を1つのレジスタに載せます。交換の相手が別のレジスタにある段 (j >= 8) はレジスタ同士の min/max、
+// 同じレジスタの中にある段 (j < 8) は相手のレーンを並べ替えた (permute) レジスタとの min/max から、
+// レーンごとに小さい方と大きい方のどちらを残すかを選びます。
+__attribute__((target("avx2")))
+inline void sort_network_avx2(int* data, size_t n) {
+    const size_t count = n / 8;
+    __m256i v[SORT_NETWORK_MAX_SIZE / 8];
+    for (size_t r = 0; r < count; ++r) {
+        v[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 8 * r));
+    }
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i zero = _mm256_setzero_si256();
+    for (size_t k = 2; k <= n; k *= 2) {
+        const __m256i k_bit = _mm256_set1_epi32(static_cast<int>(k));
+        for (size_t j = k / 2; j > 0; j /= 2) {
+            if (j >= 8) {
+                for (size_t r = 0; r < count; ++r) {
+                    size_t partner = r ^ (j / 8);
+                    if (partner > r) {
+                        __m256i low = _mm256_min_epi32(v[r], v[partner]);
+                        __m256i high = _mm256_max_epi32(v[r], v[partner]);
+                        bool ascending = ((8 * r) & k) == 0;
+                        v[r] = ascending ? low : high;
+                        v[partner] = ascending ? high : low;
+                    }
+                }
+            } else {
+                const __m256i j_bit = _mm256_set1_epi32(static_cast<int>(j));
+                const __m256i partner = _mm256_xor_si256(lanes, j_bit);
+                // 組の前側のレーン
+                const __m256i lower = _mm256_cmpeq_epi32(_mm256_and_si256(lanes, j_bit), zero);
+                for (size_t r = 0; r < count; ++r) {
+                    __m256i index = _mm256_add_epi32(lanes, _mm256_set1_epi32(static_cast<int>(8 * r)));
+                    __m256i descending = _mm256_cmpeq_epi32(_mm256_and_si256(index, k_bit), k_bit);
+                    __m256i take_low = _mm256_xor_si256(lower, descending);
+                    __m256i other = _mm256_permutevar8x32_epi32(v[r], partner);
+                    __m256i low = _mm256_min_epi32(v[r], other);
+                    __m256i high = _mm256_max_epi32(v[r], other);
+                    v[r] = _mm256_blendv_epi8(high, low, take_low);
+                }
+            }
+        }
+    }
+    for (size_t r = 0; r < count; ++r) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + 8 * r), v[r]);
+    }
+}
+
+// AVX-512 版: 16要素を1つのレジスタに載せ、レーンの選択はマスクレジスタで行います。16要素未満は AVX2 版を使います。
+// (GCC 12 のヘッダーの _mm512_undefined_epi32 が -Wmaybe-uninitialized の誤検知を出すため、この関数では抑止します)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+__attribute__((target("avx512f")))
+inline void sort_network_avx512(int* data, size_t n) {
+    if (n < 16) {
+        sort_network_avx2(data, n);
+        return;
+    }
+    const size_t count = n / 16;
+    __m512i v[SORT_NETWORK_MAX_SIZE / 16];
+    for (size_t r = 0; r < count; ++r) {
+        v[r] = _mm512_loadu_si512(data + 16 * r);
+    }
+    const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    for (size_t k = 2; k <= n; k *= 2) {
+        const __m512i k_bit = _mm512_set1_epi32(static_cast<int>(k));
+        for (size_t j = k / 2; j > 0; j /= 2) {
+            if (j >= 16) {
+                for (size_t r = 0; r < count; ++r) {
+                    size_t partner = r ^ (j / 16);
+                    if (partner > r) {
+                        __m512i low = _mm512_min_epi32(v[r], v[partner]);
+                        __m512i high = _mm512_max_epi32(v[r], v[partner]);
+                        bool ascending = ((16 * r) & k) == 0;
+                        v[r] = ascending ? low : high;
+                        v[partner] = ascending ? high : low;
+                    }
+                }
+            } else {
+                const __m512i j_bit = _mm512_set1_epi32(static_cast<int>(j));
+                const __m512i partner = _mm512_xor_si512(lanes, j_bit);
+                // 組の前側のレーン
+                const __mmask16 lower = _mm512_testn_epi32_mask(lanes, j_bit);
+                for (size_t r = 0; r < count; ++r) {
+                    __m512i index = _mm512_add_epi32(lanes, _mm512_set1_epi32(static_cast<int>(16 * r)));
+                    __mmask16 descending = _mm512_test_epi32_mask(index, k_bit);
+                    __mmask16 take_low = static_cast<__mmask16>(lower ^ descending);
+                    __m512i other = _mm512_permutexvar_epi32(partner, v[r]);
+                    __m512i low = _mm512_min_epi32(v[r], other);
+                    __m512i high = _mm512_max_epi32(v[r], other);
+                    v[r] = _mm512_mask_blend_epi32(take_low, high, low);
+                }
+            }
+        }
+    }
+    for (size_t r = 0; r < count; ++r) {
+        _mm512_storeu_si512(data + 16 * r, v[r]);
+    }
+}
+#pragma GCC diagnostic pop
+#endif
+
+// 実行中の CPU で使えるソーティングネットワークの実装
+struct SortNetworkKernel {
+    void (*sort)(int*, size_t);
+    const char* name;
+    // SIMD 命令を使う実装か (スカラー版は挿入ソートより遅いため、他のソートの部品としては使わない)
+    bool vectorized;
+};
+
+// CPU の命令セットを調べ、実行中の CPU で使える実装をすべて返します (スカラー版、AVX2 版、AVX-512 版の順)。
+inline std::vector<SortNetworkKernel> supported_sort_network_kernels() {
+    std::vector<SortNetworkKernel> kernels;
+    kernels.push_back(SortNetworkKernel{sort_network_scalar, "scalar", false});
+#if SORT_NETWORK_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back(SortNetworkKernel{sort_network_avx2, "avx2", true});
+    }
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2")) {
+        kernels.push_back(SortNetworkKernel{sort_network_avx512, "avx512", true});
+    }
+#endif
+    return kernels;
+}
+
+// 使える実装のうち、AVX-512 > AVX2 > スカラーの順で最も速いものを選びます。
+inline SortNetworkKernel select_sort_network_kernel() {
+    return supported_sort_network_kernels().back();
+}
+
+// 選んだ実装 (最初の呼び出しで1度だけ選びます)
+inline const SortNetworkKernel& sort_network_kernel() {
+    static const SortNetworkKernel kernel = select_sort_network_kernel();
+    return kernel;
+}
+
+// data[0], ..., data[size - 1] (size <= SORT_NETWORK_MAX_SIZE) をソーティングネットワークで昇順に並べ替えます。
+// 長さが2のべき乗でないときは、int の最大値で埋めた作業領域に写してから並べ替えます。
+inline void network_sort(int* data, size_t size) {
+    if (size <= 1) {
+        return;
+    }
+    size_t n = 8;
+    while (n < size) {
+        n *= 2;
+    }
+    if (n == size) {
+        sort_network_kernel().sort(data, n);
+        return;
+    }
+    alignas(64) int padded[SORT_NETWORK_MAX_SIZE];
+    std::copy(data, data + size, padded);
+    std::fill(padded + size, padded + n, std::numeric_limits<int>::max());
+    sort_network_kernel().sort(padded, n);
+    std::copy(padded, padded + size, data);
+}
+
+#endif
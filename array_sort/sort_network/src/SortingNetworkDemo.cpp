@@ -0,0 +1,162 @@
+// C++
+// 配列の並び替え: ソーティングネットワーク (Bitonic Sorting Network)
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <cstddef>
+#include <functional>
+
+#include "SortingNetwork.h"
+#include "../../sort_merge/src/AdaptiveMergeSort.h"
+
+class ArrayData {
+private:
+    std::vector<int> _data;
+
+public:
+    ArrayData() {}
+
+    std::vector<int> get() {
+        return _data;
+    }
+
+    bool set(const std::vector<int>& data) {
+        _data = data;
+        return true;
+    }
+
+    // SORT_NETWORK_MAX_SIZE 以下の配列はソーティングネットワークだけで並べ替えます。
+    // それより長い配列は SORT_NETWORK_MAX_SIZE 個ずつをネットワークで並べてから、マージソートと同じ merge_sorted_runs でボトムアップにマージします。
+    bool sort() {
+        size_t size = _data.size();
+        if (size <= SORT_NETWORK_MAX_SIZE) {
+            network_sort(_data.data(), size);
+            return true;
+        }
+        for (size_t start = 0; start < size; start += SORT_NETWORK_MAX_SIZE) {
+            network_sort(_data.data() + start, std::min(SORT_NETWORK_MAX_SIZE, size - start));
+        }
+        std::vector<int> buffer(size);
+        merge_sorted_runs(_data.data(), buffer.data(), size, SORT_NETWORK_MAX_SIZE, std::less<>());
+        return true;
+    }
+};
+
+void printVector(const std::vector<int>& vec) {
+    std::cout << "  [";
+    for (size_t i = 0; i < vec.size(); i++) {
+        std::cout << vec[i];
+        if (i < vec.size() - 1) {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+}
+
+int main() {
+    std::cout << "SortingNetwork TEST -----> start" << std::endl;
+
+    ArrayData array_data;
+
+    // ランダムな整数の配列
+    std::cout << "\nsort" << std::endl;
+    std::vector<int> input1 = {64, 34, 25, 12, 22, 11, 90};
+    std::cout << "  ソート前: ";
+    printVector(input1);
+    array_data.set(input1);
+    array_data.sort();
+    std::cout << "  ソート後: ";
+    printVector(array_data.get());
+
+    // 既にソートされている配列
+    std::cout << "\nsort" << std::endl;
+    std::vector<int> input2 = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    std::cout << "  ソート前: ";
+    printVector(input2);
+    array_data.set(input2);
+    array_data.sort();
+    std::cout << "  ソート後: ";
+    printVector(array_data.get());
+
+    // 逆順の配列
+    std::cout << "\nsort" << std::endl;
+    std::vector<int> input3 = {10, 9, 8, 7, 6, 5, 4, 3, 2, 1};
+    std::cout << "  ソート前: ";
+    printVector(input3);
+    array_data.set(input3);
+    array_data.sort();
+    std::cout << "  ソート後: ";
+    printVector(array_data.get());
+
+    // 重複要素を含む配列
+    std::cout << "\nsort" << std::endl;
+    std::vector<int> input4 = {10, 9, 8, 7, 6, 10, 9, 8, 7, 6};
+    std::cout << "  ソート前: ";
+    printVector(input4);
+    array_data.set(input4);
+    array_data.sort();
+    std::cout << "  ソート後: ";
+    printVector(array_data.get());
+
+    // 空の配列
+    std::cout << "\nsort" << std::endl;
+    std::vector<int> input5 = {};
+    std::cout << "  ソート前: ";
+    printVector(input5);
+    array_data.set(input5);
+    array_data.sort();
+    std::cout << "  ソート後: ";
+    printVector(array_data.get());
+
+    // 長さ 1..256 の配列をたくさん並べ替え、実行中の CPU で使えるすべての実装の結果をスカラー版と比べる
+    std::cout << "\nnetwork_sort" << std::endl;
+    std::cout << "  使用する実装: " << sort_network_kernel().name << std::endl;
+    for (const SortNetworkKernel& kernel : supported_sort_network_kernels()) {
+        std::mt19937 rng(1);
+        int mismatches = 0;
+        for (int trial = 0; trial < 10000; ++trial) {
+            size_t size = 1 + rng() % SORT_NETWORK_MAX_SIZE;
+            std::vector<int> values(size);
+            for (int& value : values) {
+                value = static_cast<int>(rng());
+            }
+            size_t n = 8;
+            while (n < size) {
+                n *= 2;
+            }
+            values.resize(n, std::numeric_limits<int>::max());
+            std::vector<int> expected = values;
+            sort_network_scalar(expected.data(), n);
+            kernel.sort(values.data(), n);
+            if (values != expected) {
+                ++mismatches;
+            }
+        }
+        std::cout << "  " << kernel.name << ": スカラー版と異なる結果の数: " << mismatches << std::endl;
+    }
+
+    // 実行時に選んだ実装で、2のべき乗でない長さも正しく並べ替えられるか確かめる
+    std::mt19937 rng(2);
+    int unsorted = 0;
+    for (int trial = 0; trial < 10000; ++trial) {
+        size_t size = 1 + rng() % SORT_NETWORK_MAX_SIZE;
+        std::vector<int> values(size);
+        for (int& value : values) {
+            value = static_cast<int>(rng());
+        }
+        std::vector<int> expected = values;
+        std::sort(expected.begin(), expected.end());
+        network_sort(values.data(), size);
+        if (values != expected) {
+            ++unsorted;
+        }
+    }
+    std::cout << "  network_sort: std::sort と異なる結果の数: " << unsorted << std::endl;
+
+    std::cout << "\nSortingNetwork TEST <----- end" << std::endl;
+
+    return 0;
+}
@@ -3,65 +3,671 @@
 
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include <string>
+#include <thread>
+#include <random>
+#include <cstddef>
+#include <limits>
+#include <memory>
 
-class ArrayData {
-private:
-    std::vector<int> _data;
-
-    std::vector<int> _quick_sort(const std::vector<int>& target) {
-        // 空の配列または要素が1つの場合はそのまま返す（基底条件）
-        if (target.size() <= 1) {
-            return target;
-        }
-        
-        // ピボットを選択（この実装では最後の要素を選択）
-        int pivot = target.back();
-        
-        // ピボットより小さい要素と大きい要素に分ける
-        std::vector<int> left;
-        std::vector<int> right;
-        
-        // 最後の要素（ピボット）を除いて配列をスキャン
-        for (size_t i = 0; i < target.size() - 1; i++) {
-            if (target[i] <= pivot) {
-                left.push_back(target[i]);
+#include "../../common/src/WorkStealingPool.h"
+#include "../../sort_network/src/SortingNetwork.h"
+#include "../../sort_merge/src/AdaptiveMergeSort.h"
+#include "../../sort_radix/src/RadixSort.h"
+
+// 以下のクイックソートの本体 (sift_down から pdq_sort まで) は、Orson Peters による
+// pdqsort (pattern-defeating quicksort, https://github.com/orlp/pdqsort) を、射影付きの比較・
+// ソーティングネットワーク・並列化に合わせて改変して移植したものです。
+// partition_right のブロック分割は、Stefan Edelkamp と Armin Weiß による BlockQuicksort
+// (BlockQuicksort: Avoiding Branch Mispredictions in Quicksort, ESA 2016) の手法を pdqsort 経由で取り入れています。
+// pdqsort は次の zlib ライセンスで公開されています。
+//
+//   Copyright (c) 2021 Orson Peters
+//
+//   This software is provided 'as-is', without any express or implied warranty. In no event will the
+//   authors be held liable for any damages arising from the use of this software.
+//
+//   Permission is granted to anyone to use this software for any purpose, including commercial
+//   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+//
+//   1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+//      original software. If you use this software in a product, an acknowledgment in the product
+//      documentation would be appreciated but is not required.
+//
+//   2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+//      being the original software.
+//
+//   3. This notice may not be removed or altered from any source distribution.
+
+// これより短い区間は挿入ソート (SIMD のソーティングネットワークが使える CPU ではネットワーク) で並べ替える
+const long INSERTION_SORT_THRESHOLD = 24;
+// これより長い区間では、9つの要素の中央値の中央値 (ninther) をピボットにする
+const long NINTHER_THRESHOLD = 128;
+// ほぼ整列済みの区間を挿入ソートで仕上げるときに、移動してよい要素数の上限
+const long PARTIAL_INSERTION_SORT_LIMIT = 8;
+// ブロック分割で一度に調べる要素数 (位置を unsigned char に記録できる大きさ)
+const size_t PARTITION_BLOCK_SIZE = 64;
+const size_t CACHELINE_SIZE = 64;
+// 並列ソートで、これより長い区間だけを別のタスクに分ける
+const long PARALLEL_SORT_GRAIN = 1 << 14;
+// 並列ソートで区間を複数のタスクで分割するときの、1つのタスクが受け持つブロックの最小の長さ
+const long PARALLEL_PARTITION_GRAIN = 1 << 18;
+
+// [first, first + size) の位置 root から下へ、最大ヒープの条件を満たすように要素を沈めます。
+template <typename T, typename Less>
+void sift_down(T* first, long root, long size, Less less) {
+    T value = std::move(first[root]);
+    while (2 * root + 1 < size) {
+        long child = 2 * root + 1;
+        if (child + 1 < size && less(first[child], first[child + 1])) {
+            ++child;
+        }
+        if (!less(value, first[child])) {
+            break;
+        }
+        first[root] = std::move(first[child]);
+        root = child;
+    }
+    first[root] = std::move(value);
+}
+
+// [first, last) をヒープソートで並べ替えます。偏った分割が続いたときの代わりに使います。
+template <typename T, typename Less>
+void heap_sort(T* first, T* last, Less less) {
+    long size = last - first;
+    for (long i = size / 2 - 1; i >= 0; --i) {
+        sift_down(first, i, size, less);
+    }
+    for (long i = size - 1; i > 0; --i) {
+        std::swap(first[0], first[i]);
+        sift_down(first, 0, i, less);
+    }
+}
+
+// *a, *b, *c を並べ替え、中央値を *b に置きます。
+template <typename T, typename Less>
+void sort3(T* a, T* b, T* c, Less less) {
+    if (less(*b, *a)) {
+        std::swap(*a, *b);
+    }
+    if (less(*c, *b)) {
+        std::swap(*b, *c);
+        if (less(*b, *a)) {
+            std::swap(*a, *b);
+        }
+    }
+}
+
+// [first, last) を挿入ソートで並べ替えます。first の直前に区間のどの要素以下でもある値があることを前提に、
+// 先頭の境界の確認を省きます。
+template <typename T, typename Less>
+void unguarded_insertion_sort(T* first, T* last, Less less) {
+    for (T* i = first + 1; i < last; ++i) {
+        T value = std::move(*i);
+        T* j = i;
+        while (less(value, *(j - 1))) {
+            *j = std::move(*(j - 1));
+            --j;
+        }
+        *j = std::move(value);
+    }
+}
+
+// [first, last) を挿入ソートで並べ替えますが、移動した要素数が PARTIAL_INSERTION_SORT_LIMIT を
+// 超えたら途中でやめて false を返します。ほぼ整列済みの区間だけを安く仕上げるために使います。
+template <typename T, typename Less>
+bool partial_insertion_sort(T* first, T* last, Less less) {
+    long moves = 0;
+    for (T* i = first + 1; i < last; ++i) {
+        T* j = i;
+        if (less(*i, *(j - 1))) {
+            T value = std::move(*i);
+            do {
+                *j = std::move(*(j - 1));
+                --j;
+            } while (j > first && less(value, *(j - 1)));
+            *j = std::move(value);
+            moves += i - j;
+            if (moves > PARTIAL_INSERTION_SORT_LIMIT) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 左側の left_base + offsets_left[i] と右側の right_base - offsets_right[i] の要素を num 組入れ替えます。
+// 左右に残る組の数が異なるときは、入れ替えの代わりに要素を順に回して代入の回数を減らします。
+template <typename T>
+void swap_offsets(T* left_base, T* right_base, const unsigned char* offsets_left,
+                  const unsigned char* offsets_right, size_t num, bool use_swaps) {
+    if (use_swaps) {
+        for (size_t i = 0; i < num; ++i) {
+            std::swap(*(left_base + offsets_left[i]), *(right_base - offsets_right[i]));
+        }
+    } else if (num > 0) {
+        T* left = left_base + offsets_left[0];
+        T* right = right_base - offsets_right[0];
+        T value = std::move(*left);
+        *left = std::move(*right);
+        for (size_t i = 1; i < num; ++i) {
+            left = left_base + offsets_left[i];
+            *right = std::move(*left);
+            right = right_base - offsets_right[i];
+            *left = std::move(*right);
+        }
+        *right = std::move(value);
+    }
+}
+
+// 先頭のピボットで [first, last) をピボットより小さい要素とピボット以上の要素に分け、ピボットの位置を返します。
+// 左右の端から PARTITION_BLOCK_SIZE 個ずつ、反対側へ移すべき要素の位置を比較結果の足し算で記録し
+// (分岐がないため、ランダムな入力でも分岐予測の失敗が起きません)、記録した要素をまとめて入れ替えます。
+// 入れ替えが1度も必要なかった場合は *already_partitioned を true にします。
+// (pdqsort の partition_right_branchless を移植したもので、ブロック分割は BlockQuicksort の手法です)
+template <typename T, typename Less>
+T* partition_right(T* first, T* last, Less less, bool* already_partitioned) {
+    T* begin = first;
+    T pivot = std::move(*first);
+
+    // ピボットを選ぶときに、末尾にはピボット以上の要素が置かれているため、左からの走査は範囲の確認が要らない
+    while (less(*++first, pivot)) {
+    }
+    // 左から1つも進まなかった場合だけ、右からの走査が先頭を越えないように確認する
+    if (first - 1 == begin) {
+        while (first < last && !less(*--last, pivot)) {
+        }
+    } else {
+        while (!less(*--last, pivot)) {
+        }
+    }
+    *already_partitioned = first >= last;
+
+    if (!*already_partitioned) {
+        std::swap(*first, *last);
+        ++first;
+
+        alignas(CACHELINE_SIZE) unsigned char offsets_left[PARTITION_BLOCK_SIZE];
+        alignas(CACHELINE_SIZE) unsigned char offsets_right[PARTITION_BLOCK_SIZE];
+        T* left_base = first;
+        T* right_base = last;
+        size_t num_left = 0;
+        size_t num_right = 0;
+        size_t start_left = 0;
+        size_t start_right = 0;
+        while (first < last) {
+            // 記録が空の側だけ新しいブロックを調べる。残りが少ないときは、空の側で残りを分け合う
+            size_t num_unknown = last - first;
+            size_t left_split = num_left == 0 ? (num_right == 0 ? num_unknown / 2 : num_unknown) : 0;
+            size_t right_split = num_right == 0 ? (num_unknown - left_split) : 0;
+            left_split = std::min(left_split, PARTITION_BLOCK_SIZE);
+            right_split = std::min(right_split, PARTITION_BLOCK_SIZE);
+
+            for (size_t i = 0; i < left_split; ++i) {
+                offsets_left[num_left] = static_cast<unsigned char>(i);
+                num_left += !less(*first, pivot);
+                ++first;
+            }
+            for (size_t i = 0; i < right_split; ++i) {
+                offsets_right[num_right] = static_cast<unsigned char>(i + 1);
+                num_right += less(*--last, pivot);
+            }
+
+            size_t num = std::min(num_left, num_right);
+            swap_offsets(left_base, right_base, offsets_left + start_left, offsets_right + start_right,
+                         num, num_left == num_right);
+            num_left -= num;
+            num_right -= num;
+            start_left += num;
+            start_right += num;
+            if (num_left == 0) {
+                start_left = 0;
+                left_base = first;
+            }
+            if (num_right == 0) {
+                start_right = 0;
+                right_base = last;
+            }
+        }
+
+        // 片側に残った記録の要素を、境界へ寄せる
+        if (num_left) {
+            while (num_left--) {
+                std::swap(*(left_base + offsets_left[start_left + num_left]), *--last);
+            }
+            first = last;
+        }
+        if (num_right) {
+            while (num_right--) {
+                std::swap(*(right_base - offsets_right[start_right + num_right]), *first);
+                ++first;
+            }
+        }
+    }
+
+    T* pivot_position = first - 1;
+    *begin = std::move(*pivot_position);
+    *pivot_position = std::move(pivot);
+    return pivot_position;
+}
+
+// 先頭のピボットで [first, last) をピボット以下の要素とピボットより大きい要素に分け、ピボットの位置を返します。
+// 区間の直前の要素がピボットと等しいときに使います。このときピボット以下の要素はすべてピボットと等しいので、
+// 左側はそれ以上並べ替える必要がなく、重複の多い入力でも値の種類ごとに O(n) の手間で片付きます。
+template <typename T, typename Less>
+T* partition_left(T* first, T* last, Less less) {
+    T* begin = first;
+    T* end = last;
+    T pivot = std::move(*first);
+
+    while (less(pivot, *--last)) {
+    }
+    if (last + 1 == end) {
+        while (first < last && !less(pivot, *++first)) {
+        }
+    } else {
+        while (!less(pivot, *++first)) {
+        }
+    }
+    while (first < last) {
+        std::swap(*first, *last);
+        while (less(pivot, *--last)) {
+        }
+        while (!less(pivot, *++first)) {
+        }
+    }
+
+    *begin = std::move(*last);
+    *last = std::move(pivot);
+    return last;
+}
+
+// パターン破りクイックソート (pattern-defeating quicksort) の本体です。
+// - ピボットは先頭・中央・末尾の中央値、長い区間では ninther で選び、区間の先頭に置く
+// - 区間の直前の要素がピボットと等しければ、partition_left でピボットと等しい要素をまとめて取り除く
+// - 分割で入れ替えが起きなかった区間は整列済みの可能性が高いため、両側を partial_insertion_sort で仕上げてみる
+// - 片側が 1/8 未満の偏った分割が続いたら、要素を入れ替えて入力のパターンを崩し、
+//   bad_allowed 回を超えたらヒープソートに切り替えて最悪でも O(n log n) にする
+// leftmost は区間が配列の先頭から始まる (直前に要素がない) ことを表します。
+// 分割は fork.partition (partition_right に当たる) と fork.partition_equal (partition_left に当たる) で行い、
+// ピボットの左側の区間は fork(first, last, bad_allowed, leftmost) で並べ替え、右側の区間はこのループで続けます。
+// (pdqsort の pdqsort_loop を移植し、分割と左側の再帰を fork に置き換えたものです)
+template <typename T, typename Less, typename Fork>
+void pdq_sort(T* first, T* last, int bad_allowed, bool leftmost, Less less, Fork& fork) {
+    while (true) {
+        long size = last - first;
+        if (size < INSERTION_SORT_THRESHOLD) {
+            if constexpr (std::is_same<T, int>::value && is_ascending_int_less<Less>::value) {
+                if (sort_network_kernel().vectorized) {
+                    network_sort(first, size);
+                    return;
+                }
+            }
+            if (leftmost) {
+                insertion_sort(first, last, less);
             } else {
-                right.push_back(target[i]);
+                unguarded_insertion_sort(first, last, less);
             }
+            return;
+        }
+
+        long half = size / 2;
+        if (size > NINTHER_THRESHOLD) {
+            sort3(first, first + half, last - 1, less);
+            sort3(first + 1, first + (half - 1), last - 2, less);
+            sort3(first + 2, first + (half + 1), last - 3, less);
+            sort3(first + (half - 1), first + half, first + (half + 1), less);
+            std::swap(*first, *(first + half));
+        } else {
+            sort3(first + half, first, last - 1, less);
+        }
+
+        if (!leftmost && !less(*(first - 1), *first)) {
+            first = fork.partition_equal(first, last) + 1;
+            continue;
+        }
+
+        bool already_partitioned;
+        T* pivot_position = fork.partition(first, last, &already_partitioned);
+        long left_size = pivot_position - first;
+        long right_size = last - (pivot_position + 1);
+
+        if (left_size < size / 8 || right_size < size / 8) {
+            if (--bad_allowed == 0) {
+                heap_sort(first, last, less);
+                return;
+            }
+            if (left_size >= INSERTION_SORT_THRESHOLD) {
+                std::swap(*first, *(first + left_size / 4));
+                std::swap(*(pivot_position - 1), *(pivot_position - left_size / 4));
+                if (left_size > NINTHER_THRESHOLD) {
+                    std::swap(*(first + 1), *(first + (left_size / 4 + 1)));
+                    std::swap(*(first + 2), *(first + (left_size / 4 + 2)));
+                    std::swap(*(pivot_position - 2), *(pivot_position - (left_size / 4 + 1)));
+                    std::swap(*(pivot_position - 3), *(pivot_position - (left_size / 4 + 2)));
+                }
+            }
+            if (right_size >= INSERTION_SORT_THRESHOLD) {
+                std::swap(*(pivot_position + 1), *(pivot_position + (1 + right_size / 4)));
+                std::swap(*(last - 1), *(last - right_size / 4));
+                if (right_size > NINTHER_THRESHOLD) {
+                    std::swap(*(pivot_position + 2), *(pivot_position + (2 + right_size / 4)));
+                    std::swap(*(pivot_position + 3), *(pivot_position + (3 + right_size / 4)));
+                    std::swap(*(last - 2), *(last - (1 + right_size / 4)));
+                    std::swap(*(last - 3), *(last - (2 + right_size / 4)));
+                }
+            }
+        } else if (already_partitioned && partial_insertion_sort(first, pivot_position, less) &&
+                   partial_insertion_sort(pivot_position + 1, last, less)) {
+            return;
+        }
+
+        fork(first, pivot_position, bad_allowed, leftmost);
+        first = pivot_position + 1;
+        leftmost = false;
+    }
+}
+
+// 区間を同じスレッドで分割し、左側の区間を同じスレッドで再帰して並べ替えます。
+template <typename Less>
+struct SequentialFork {
+    Less less;
+
+    template <typename T>
+    T* partition(T* first, T* last, bool* already_partitioned) {
+        return partition_right(first, last, less, already_partitioned);
+    }
+
+    template <typename T>
+    T* partition_equal(T* first, T* last) {
+        return partition_left(first, last, less);
+    }
+
+    template <typename T>
+    void operator()(T* first, T* last, int bad_allowed, bool leftmost) {
+        pdq_sort(first, last, bad_allowed, leftmost, less, *this);
+    }
+};
+
+// 偏った分割を許す回数 (log2(n))
+int pdq_bad_allowed(long size) {
+    int bad_allowed = 0;
+    for (; size > 1; size >>= 1) {
+        ++bad_allowed;
+    }
+    return bad_allowed;
+}
+
+// [first, last) を less の順に並べ替えます。
+template <typename T, typename Less = std::less<>>
+void quick_sort(T* first, T* last, Less less = Less()) {
+    if (last - first > 1) {
+        SequentialFork<Less> fork = {less};
+        pdq_sort(first, last, pdq_bad_allowed(last - first), true, less, fork);
+    }
+}
+
+// [first, last) を、pred を満たす要素と満たさない要素に両端から入れ替えて分け、境界を返します。
+// 要素を入れ替えたときは *moved を true にします。並列分割の各ブロックで使います。
+template <typename T, typename Pred>
+T* partition_block(T* first, T* last, Pred pred, bool* moved) {
+    *moved = false;
+    while (true) {
+        while (first < last && pred(*first)) {
+            ++first;
+        }
+        while (first < last && !pred(*(last - 1))) {
+            --last;
+        }
+        if (first == last) {
+            return first;
+        }
+        std::swap(*first, *(last - 1));
+        ++first;
+        --last;
+        *moved = true;
+    }
+}
+
+// 配列の中の区間の列を、つなげて1列として扱います (並列分割で、境界の反対側にある要素を数えて入れ替えるのに使います)。
+template <typename T>
+struct PartitionSpans {
+    std::vector<T*> begins;
+    std::vector<T*> ends;
+    // 各区間の先頭の要素が、つなげた列の何番目に当たるか
+    std::vector<size_t> starts;
+    size_t size = 0;
+
+    void add(T* begin, T* end) {
+        if (begin < end) {
+            begins.push_back(begin);
+            ends.push_back(end);
+            starts.push_back(size);
+            size += end - begin;
+        }
+    }
+
+    // つなげた列の k 番目の要素を含む区間の番号
+    size_t find(size_t k) const {
+        return std::upper_bound(starts.begin(), starts.end(), k) - starts.begin() - 1;
+    }
+};
+
+// 区間の列 left と right をそれぞれつなげた列の、[k, end) 番目の要素どうしを入れ替えます。
+template <typename T>
+void swap_spans(const PartitionSpans<T>& left, const PartitionSpans<T>& right, size_t k, size_t end) {
+    size_t i = left.find(k);
+    size_t j = right.find(k);
+    T* left_position = left.begins[i] + (k - left.starts[i]);
+    T* right_position = right.begins[j] + (k - right.starts[j]);
+    while (k < end) {
+        size_t num = std::min({static_cast<size_t>(left.ends[i] - left_position),
+                               static_cast<size_t>(right.ends[j] - right_position), end - k});
+        std::swap_ranges(left_position, left_position + num, right_position);
+        k += num;
+        left_position += num;
+        right_position += num;
+        if (k < end && left_position == left.ends[i]) {
+            left_position = left.begins[++i];
         }
-        
-        // 左側の部分配列をソート
-        std::vector<int> sorted_left = _quick_sort(left);
-        // 右側の部分配列をソート
-        std::vector<int> sorted_right = _quick_sort(right);
-        
-        // 左側の部分配列、ピボット、右側の部分配列を結合
-        std::vector<int> result;
-        result.insert(result.end(), sorted_left.begin(), sorted_left.end());
-        result.push_back(pivot);
-        result.insert(result.end(), sorted_right.begin(), sorted_right.end());
-        
-        return result;
+        if (k < end && right_position == right.ends[j]) {
+            right_position = right.begins[++j];
+        }
+    }
+}
+
+// [first, last) を、pred を満たす要素と満たさない要素に num_blocks 個のタスクで分け、境界を返します。
+// 区間を num_blocks 個のブロックに分けてそれぞれを並列に分割した後、全体の境界より左にある満たさない要素と
+// 右にある満たす要素 (同じ数だけあります) を、ブロックをまたいで並列に入れ替えます。
+// 要素を入れ替えたときは *moved を true にします。
+template <typename T, typename Pred>
+T* parallel_partition(WorkStealingPool& pool, T* first, T* last, size_t num_blocks, Pred pred, bool* moved) {
+    size_t size = last - first;
+    std::vector<T*> block_firsts(num_blocks + 1);
+    for (size_t b = 0; b <= num_blocks; ++b) {
+        block_firsts[b] = first + size * b / num_blocks;
+    }
+    std::vector<T*> block_boundaries(num_blocks);
+    std::unique_ptr<bool[]> block_moved(new bool[num_blocks]);
+    TaskGroup group;
+    for (size_t b = 1; b < num_blocks; ++b) {
+        pool.spawn(group, [&, b]() {
+            block_boundaries[b] = partition_block(block_firsts[b], block_firsts[b + 1], pred, &block_moved[b]);
+        });
     }
+    block_boundaries[0] = partition_block(block_firsts[0], block_firsts[1], pred, &block_moved[0]);
+    pool.wait(group);
+
+    T* boundary = first;
+    *moved = false;
+    for (size_t b = 0; b < num_blocks; ++b) {
+        boundary += block_boundaries[b] - block_firsts[b];
+        *moved = *moved || block_moved[b];
+    }
+    PartitionSpans<T> left;
+    PartitionSpans<T> right;
+    for (size_t b = 0; b < num_blocks; ++b) {
+        left.add(block_boundaries[b], std::min(block_firsts[b + 1], boundary));
+        right.add(std::max(block_firsts[b], boundary), block_boundaries[b]);
+    }
+    if (left.size == 0) {
+        return boundary;
+    }
+    *moved = true;
+
+    size_t num_tasks = std::min(num_blocks, (left.size + PARALLEL_PARTITION_GRAIN - 1) / PARALLEL_PARTITION_GRAIN);
+    for (size_t t = 1; t < num_tasks; ++t) {
+        pool.spawn(group, [&, t]() {
+            swap_spans(left, right, left.size * t / num_tasks, left.size * (t + 1) / num_tasks);
+        });
+    }
+    swap_spans(left, right, 0, left.size / num_tasks);
+    pool.wait(group);
+    return boundary;
+}
+
+// 左側の区間が PARALLEL_SORT_GRAIN より長ければ、別のタスクとして並べ替えます。
+// 左右の区間は重ならず、区間の直前の要素 (確定したピボット) は読むだけなので、タスク間で同期は要りません。
+// 分割する区間が PARALLEL_PARTITION_GRAIN の2倍以上あれば、分割も parallel_partition で複数のタスクに分けます。
+// 最初の数回の分割は配列全体を1つのスレッドでなめるため、これがないと並列に動けるタスクがそろうまで
+// ほかのスレッドが待つことになります。
+template <typename Less>
+struct ParallelFork {
+    WorkStealingPool* pool;
+    TaskGroup* group;
+    Less less;
+
+    // size 要素の区間を分割するブロックの数 (2未満なら1つのスレッドで分割します)
+    size_t partition_blocks(long size) const {
+        return std::min(static_cast<size_t>(pool->size()), static_cast<size_t>(size / PARALLEL_PARTITION_GRAIN));
+    }
+
+    // 先頭のピボットを除いた区間を pred で並列に分割し、ピボットを境界の直前に移してその位置を返します。
+    template <typename T, typename Pred>
+    T* parallel_partition_around_first(T* first, T* last, size_t num_blocks, Pred pred, bool* moved) {
+        T* pivot_position = parallel_partition(*pool, first + 1, last, num_blocks, pred, moved) - 1;
+        if (pivot_position != first) {
+            std::swap(*first, *pivot_position);
+        }
+        return pivot_position;
+    }
+
+    template <typename T>
+    T* partition(T* first, T* last, bool* already_partitioned) {
+        size_t num_blocks = partition_blocks(last - first);
+        if (num_blocks < 2) {
+            return partition_right(first, last, less, already_partitioned);
+        }
+        const T& pivot = *first;
+        Less compare = less;
+        bool moved;
+        T* pivot_position = parallel_partition_around_first(first, last, num_blocks,
+            [&pivot, compare](const T& value) { return compare(value, pivot); }, &moved);
+        *already_partitioned = !moved;
+        return pivot_position;
+    }
+
+    template <typename T>
+    T* partition_equal(T* first, T* last) {
+        size_t num_blocks = partition_blocks(last - first);
+        if (num_blocks < 2) {
+            return partition_left(first, last, less);
+        }
+        const T& pivot = *first;
+        Less compare = less;
+        bool moved;
+        return parallel_partition_around_first(first, last, num_blocks,
+            [&pivot, compare](const T& value) { return !compare(pivot, value); }, &moved);
+    }
+
+    template <typename T>
+    void operator()(T* first, T* last, int bad_allowed, bool leftmost) {
+        if (last - first <= PARALLEL_SORT_GRAIN) {
+            SequentialFork<Less> sequential = {less};
+            pdq_sort(first, last, bad_allowed, leftmost, less, sequential);
+            return;
+        }
+        ParallelFork fork = *this;
+        pool->spawn(*group, [=]() mutable {
+            pdq_sort(first, last, bad_allowed, leftmost, fork.less, fork);
+        });
+    }
+};
+
+// [first, last) を num_threads 個 (0 の場合はハードウェアの並列数) のスレッドで less の順に並べ替えます。
+template <typename T, typename Less = std::less<>>
+void parallel_quick_sort(T* first, T* last, unsigned int num_threads = 0, Less less = Less()) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (num_threads == 1 || last - first <= PARALLEL_SORT_GRAIN) {
+        quick_sort(first, last, less);
+        return;
+    }
+    WorkStealingPool pool(num_threads);
+    TaskGroup group;
+    ParallelFork<Less> fork = {&pool, &group, less};
+    pdq_sort(first, last, pdq_bad_allowed(last - first), true, less, fork);
+    pool.wait(group);
+}
+
+// 要素の型 T の配列を、要素を projection で写したキーの compare の順に並べ替えます。
+// キーが整数か float/double で、compare が std::less (昇順) か std::greater (降順) のときは基数ソートを、
+// それ以外のときはクイックソートを、コンパイル時に選びます。
+// 例えば BasicArrayData<Record, std::greater<>, int Record::*> は、Record を key の降順に並べ替えます。
+template <typename T = int, typename Compare = std::less<>, typename Projection = IdentityProjection>
+class BasicArrayData {
+private:
+    typedef RadixDispatch<T, Compare, Projection> Dispatch;
+
+    std::vector<T> _data;
+    ProjectedLess<Compare, Projection> _less;
 
 public:
-    ArrayData() {}
+    BasicArrayData(Compare compare = Compare(), Projection projection = Projection())
+        : _less{compare, projection} {}
 
-    std::vector<int> get() {
+    std::vector<T> get() {
         return _data;
     }
 
-    bool set(const std::vector<int>& data) {
+    bool set(const std::vector<T>& data) {
         _data = data;
         return true;
     }
 
     bool sort() {
-        _data = _quick_sort(_data);
+        if constexpr (Dispatch::supported) {
+            radix_sort(_data.data(), _data.size(), 1, _less.projection, Dispatch::descending);
+        } else {
+            quick_sort(_data.data(), _data.data() + _data.size(), _less);
+        }
+        return true;
+    }
+
+    // num_threads 個 (0 の場合はハードウェアの並列数) のスレッドで並べ替えます。
+    bool parallel_sort(unsigned int num_threads = 0) {
+        if constexpr (Dispatch::supported) {
+            radix_sort(_data.data(), _data.size(), num_threads, _less.projection, Dispatch::descending);
+        } else {
+            parallel_quick_sort(_data.data(), _data.data() + _data.size(), num_threads, _less);
+        }
         return true;
     }
 };
 
+typedef BasicArrayData<int> ArrayData;
+
+// キーを持つレコード (BasicArrayData の例で使います)
+struct Record {
+    std::string name;
+    int key;
+};
+
 void printVector(const std::vector<int>& vec) {
     std::cout << "  [";
     for (size_t i = 0; i < vec.size(); i++) {
@@ -128,6 +734,39 @@ int main() {
     std::cout << "  ソート後: ";
     printVector(array_data.get());
 
+    // 大きな配列を並列に並べ替える
+    std::cout << "\nparallel_sort" << std::endl;
+    std::mt19937 rng(1);
+    std::vector<int> input6(1000000);
+    for (int& value : input6) {
+        value = static_cast<int>(rng() % 1000000);
+    }
+    array_data.set(input6);
+    array_data.parallel_sort();
+    std::vector<int> sorted6 = array_data.get();
+    std::cout << "  要素数: " << sorted6.size() << std::endl;
+    std::cout << "  先頭の5要素: ";
+    printVector(std::vector<int>(sorted6.begin(), sorted6.begin() + 5));
+    std::cout << "  昇順に並んでいるか: " << (std::is_sorted(sorted6.begin(), sorted6.end()) ? "true" : "false") << std::endl;
+
+    // レコードを、int の配列に写さずにメンバー key の降順で並べ替える
+    std::cout << "\nsort (Record, key の降順)" << std::endl;
+    BasicArrayData<Record, std::greater<>, int Record::*> record_data(std::greater<>(), &Record::key);
+    record_data.set({{"alice", 72}, {"bob", 95}, {"carol", 60}, {"dave", 88}, {"eve", 95}});
+    record_data.sort();
+    for (const Record& record : record_data.get()) {
+        std::cout << "  " << record.name << ": " << record.key << std::endl;
+    }
+
+    // キーが文字列のときは基数ソートを使えないため、クイックソートで name の昇順に並べ替える
+    std::cout << "\nsort (Record, name の昇順)" << std::endl;
+    BasicArrayData<Record, std::less<>, std::string Record::*> name_data(std::less<>(), &Record::name);
+    name_data.set({{"dave", 88}, {"bob", 95}, {"eve", 95}, {"alice", 72}, {"carol", 60}});
+    name_data.sort();
+    for (const Record& record : name_data.get()) {
+        std::cout << "  " << record.name << ": " << record.key << std::endl;
+    }
+
     std::cout << "\nQuickSort TEST <----- end" << std::endl;
 
     return 0;
@@ -0,0 +1,320 @@
+// C++
+// 安定なソートの共通部品: 整数と浮動小数点数のキーの LSD 基数ソート
+//
+// 基数ソートのデモが参照実装で、マージソートとクイックソートのデモも、キーが基数ソートで扱える型のときに
+// コンパイル時にこの基数ソートへ切り替えます。
+
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../sort_merge/src/AdaptiveMergeSort.h"
+
+// 1回の振り分けで扱う桁のビット数とバケットの数
+const int RADIX_BITS = 8;
+const int RADIX_BUCKETS = 1 << RADIX_BITS;
+// 書き込み結合バッファのバケットごとの大きさ (キャッシュライン1本分のバイト数)
+const size_t RADIX_WRITE_COMBINE_BYTES = 64;
+// これより要素数が少ない場合は1スレッドでソートする
+const size_t RADIX_PARALLEL_THRESHOLD = 1 << 16;
+
+// 基数ソートのキーを符号なし整数 (Bits) に写し、符号なし整数として比較したときの順序を元の順序と一致させます。
+// supported は、Key が基数ソートで扱える型かを表します。
+template <typename Key, typename Enable = void>
+struct RadixKey {
+    static constexpr bool supported = false;
+};
+
+// 整数 (bool を除く): 符号付きなら符号ビットを反転します。
+template <typename Key>
+struct RadixKey<Key, typename std::enable_if<std::is_integral<Key>::value && !std::is_same<Key, bool>::value>::type> {
+    static constexpr bool supported = true;
+    typedef typename std::make_unsigned<Key>::type Bits;
+
+    static Bits encode(Key value) {
+        const Bits sign_flip = std::is_signed<Key>::value ? Bits(Bits(1) << (sizeof(Key) * 8 - 1)) : Bits(0);
+        return static_cast<Bits>(static_cast<Bits>(value) ^ sign_flip);
+    }
+};
+
+// IEEE 754 の float/double: 負の数は全ビットを、0 以上の数は符号ビットだけを反転します。
+// -0.0 は 0.0 と同じキーに揃えるため、比較によるソートと同じく ±0.0 は等しいものとして元の順序のまま並びます。
+// (NaN は比較で順序が決まらないため、キーに含めないでください)
+template <typename Key>
+struct RadixKey<Key, typename std::enable_if<std::is_floating_point<Key>::value && std::numeric_limits<Key>::is_iec559 &&
+                                             (sizeof(Key) == 4 || sizeof(Key) == 8)>::type> {
+    static constexpr bool supported = true;
+    typedef typename std::conditional<sizeof(Key) == 4, uint32_t, uint64_t>::type Bits;
+
+    static Bits encode(Key value) {
+        if (value == 0) {
+            value = 0;
+        }
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(Key));
+        const Bits sign = Bits(1) << (sizeof(Key) * 8 - 1);
+        return (bits & sign) ? static_cast<Bits>(~bits) : static_cast<Bits>(bits ^ sign);
+    }
+};
+
+// 比較 Compare で Key を並べる順序を、基数ソートで実現できるか (std::less なら昇順、std::greater なら降順) を表します。
+template <typename Compare, typename Key>
+struct RadixOrder {
+    static constexpr bool supported = false;
+    static constexpr bool descending = false;
+};
+template <typename Key>
+struct RadixOrder<std::less<>, Key> {
+    static constexpr bool supported = true;
+    static constexpr bool descending = false;
+};
+template <typename Key>
+struct RadixOrder<std::less<Key>, Key> {
+    static constexpr bool supported = true;
+    static constexpr bool descending = false;
+};
+template <typename Key>
+struct RadixOrder<std::greater<>, Key> {
+    static constexpr bool supported = true;
+    static constexpr bool descending = true;
+};
+template <typename Key>
+struct RadixOrder<std::greater<Key>, Key> {
+    static constexpr bool supported = true;
+    static constexpr bool descending = true;
+};
+
+// num_threads 個のスレッドが揃うまで待ち合わせる、繰り返し使えるバリアです (C++20 の std::barrier と同じ使い方です)。
+class RadixBarrier {
+private:
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    const unsigned int _num_threads;
+    unsigned int _waiting = 0;
+    unsigned long _generation = 0;
+
+public:
+    explicit RadixBarrier(unsigned int num_threads) : _num_threads(num_threads) {}
+
+    // 全スレッドがここに到着するまで待ちます。最後に到着したスレッドが全員を起こします。
+    void arrive_and_wait() {
+        if (_num_threads == 1) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(_mutex);
+        unsigned long generation = _generation;
+        if (++_waiting == _num_threads) {
+            _waiting = 0;
+            ++_generation;
+            _condition.notify_all();
+            return;
+        }
+        _condition.wait(lock, [this, generation]() {
+            return _generation != generation;
+        });
+    }
+};
+
+// 基数ソートの補助配列です。要素を作らずに領域だけを確保し、最初の振り分けで要素をムーブして作るため、
+// 要素の型にデフォルトコンストラクターは要りません。
+template <typename T>
+class RadixBuffer {
+private:
+    T* _data;
+    size_t _size;
+    bool _constructed = false;
+
+public:
+    explicit RadixBuffer(size_t size) : _data(std::allocator<T>().allocate(size)), _size(size) {}
+
+    ~RadixBuffer() {
+        if (_constructed) {
+            std::destroy(_data, _data + _size);
+        }
+        std::allocator<T>().deallocate(_data, _size);
+    }
+
+    RadixBuffer(const RadixBuffer&) = delete;
+    RadixBuffer& operator=(const RadixBuffer&) = delete;
+
+    T* data() {
+        return _data;
+    }
+
+    // すべての要素を作ったか
+    bool constructed() const {
+        return _constructed;
+    }
+
+    void set_constructed() {
+        _constructed = true;
+    }
+};
+
+// 配列を、要素を projection で写したキー (整数または浮動小数点数) の昇順 (descending が true なら降順) に、
+// 下位の桁から8ビットずつ安定に振り分ける LSD 基数ソートで並べ替えます。要素そのものを振り分けるため、
+// レコードをキーの配列に写して並べ替えた後に元へ戻す必要はありません。
+// 配列を num_threads 個 (0 の場合はハードウェアの並列数) の連続した区間に分け、1桁ごとに
+//   1. 各スレッドが自分の区間の桁の出現数 (ヒストグラム) を数える
+//   2. バケット順、同じバケットの中ではスレッド順に累積和をとり、各スレッドの書き込み位置を決める
+//   3. 各スレッドが自分の区間の要素を書き込み位置へ振り分ける
+// を行います。スレッドは最初に1回だけ作り、すべての桁を通して同じ区間を受け持ちます (段階の間はバリアで待ち合わせます)。
+// 要素が小さく memcpy でコピーできる型なら、振り分けはバケットごとにキャッシュライン1本分を
+// 小さなバッファにためてからまとめて書き込む (書き込み結合) ため、256か所への散らばった書き込みでも
+// キャッシュとTLBのミスが抑えられます。それ以外の型は書き込み位置へ直接ムーブします。
+// すべての要素で同じ値になる桁は振り分けを省略します。補助配列は1つだけ確保し、桁ごとに入れ替えて使います。
+template <typename T, typename Projection = IdentityProjection>
+void radix_sort(T* data, size_t size, unsigned int num_threads = 0, Projection projection = Projection(),
+                bool descending = false) {
+    typedef typename std::decay<decltype(std::invoke(projection, *data))>::type Key;
+    typedef RadixKey<Key> Radix;
+    static_assert(Radix::supported, "radix_sort のキーは整数か float/double に対応しています");
+    typedef typename Radix::Bits Bits;
+    constexpr bool write_combine = std::is_trivially_copyable<T>::value && 2 * sizeof(T) <= RADIX_WRITE_COMBINE_BYTES;
+
+    if (size < 2) {
+        return;
+    }
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (size < RADIX_PARALLEL_THRESHOLD) {
+        num_threads = 1;
+    }
+
+    const size_t write_combine_size = write_combine ? RADIX_WRITE_COMBINE_BYTES / sizeof(T) : 0;
+    RadixBuffer<T> buffer(size);
+
+    // 各スレッドの区間と、スレッドごと・バケットごとの出現数 (累積和をとった後は書き込み位置)
+    std::vector<size_t> bounds(num_threads + 1);
+    for (unsigned int t = 0; t <= num_threads; ++t) {
+        bounds[t] = size * t / num_threads;
+    }
+    std::vector<size_t> counts(static_cast<size_t>(num_threads) * RADIX_BUCKETS);
+    // 書き込み結合バッファ (スレッドごとに RADIX_BUCKETS 本のライン。memcpy でだけ読み書きします)
+    RadixBuffer<T> write_combine_lines(static_cast<size_t>(num_threads) * RADIX_BUCKETS * write_combine_size);
+    // この桁の振り分けを省略するか、まだ要素を作っていない補助配列へ振り分けるか
+    // (スレッド 0 が累積和をとるときに決め、バリアの後で全スレッドが読む)
+    bool skip = false;
+    bool construct = false;
+    RadixBarrier barrier(num_threads);
+
+    auto worker = [&](unsigned int t) {
+        T* source = data;
+        T* destination = buffer.data();
+        size_t* count = &counts[static_cast<size_t>(t) * RADIX_BUCKETS];
+        for (int shift = 0; shift < static_cast<int>(sizeof(Bits) * 8); shift += RADIX_BITS) {
+            auto digit = [shift, descending, &projection](const T& value) {
+                Bits key = Radix::encode(std::invoke(projection, value));
+                if (descending) {
+                    key = static_cast<Bits>(~key);
+                }
+                return static_cast<unsigned int>((key >> shift) & (RADIX_BUCKETS - 1));
+            };
+
+            std::fill(count, count + RADIX_BUCKETS, 0);
+            for (size_t i = bounds[t]; i < bounds[t + 1]; ++i) {
+                ++count[digit(source[i])];
+            }
+            barrier.arrive_and_wait();
+
+            if (t == 0) {
+                // すべての要素がこの桁で同じバケットに入るなら、並び順は変わらない
+                skip = false;
+                for (int b = 0; b < RADIX_BUCKETS && !skip; ++b) {
+                    size_t bucket_total = 0;
+                    for (unsigned int u = 0; u < num_threads; ++u) {
+                        bucket_total += counts[static_cast<size_t>(u) * RADIX_BUCKETS + b];
+                    }
+                    skip = bucket_total == size;
+                }
+                size_t offset = 0;
+                for (int b = 0; b < RADIX_BUCKETS && !skip; ++b) {
+                    for (unsigned int u = 0; u < num_threads; ++u) {
+                        size_t& bucket_count = counts[static_cast<size_t>(u) * RADIX_BUCKETS + b];
+                        size_t next_offset = offset + bucket_count;
+                        bucket_count = offset;
+                        offset = next_offset;
+                    }
+                }
+                construct = !skip && destination == buffer.data() && !buffer.constructed();
+                if (construct) {
+                    buffer.set_constructed();
+                }
+            }
+            barrier.arrive_and_wait();
+            if (skip) {
+                continue;
+            }
+
+            size_t* position = count;
+            if constexpr (write_combine) {
+                T* pending = write_combine_lines.data() + static_cast<size_t>(t) * RADIX_BUCKETS * write_combine_size;
+                unsigned int filled[RADIX_BUCKETS] = {};
+                for (size_t i = bounds[t]; i < bounds[t + 1]; ++i) {
+                    unsigned int b = digit(source[i]);
+                    T* line = pending + b * write_combine_size;
+                    std::memcpy(line + filled[b]++, source + i, sizeof(T));
+                    if (filled[b] == write_combine_size) {
+                        std::memcpy(destination + position[b], line, write_combine_size * sizeof(T));
+                        position[b] += write_combine_size;
+                        filled[b] = 0;
+                    }
+                }
+                for (int b = 0; b < RADIX_BUCKETS; ++b) {
+                    std::memcpy(destination + position[b], pending + b * write_combine_size, filled[b] * sizeof(T));
+                }
+            } else if (construct) {
+                for (size_t i = bounds[t]; i < bounds[t + 1]; ++i) {
+                    ::new (static_cast<void*>(destination + position[digit(source[i])]++)) T(std::move(source[i]));
+                }
+            } else {
+                for (size_t i = bounds[t]; i < bounds[t + 1]; ++i) {
+                    destination[position[digit(source[i])]++] = std::move(source[i]);
+                }
+            }
+            // 次の桁では、他のスレッドが書き込んだ要素も読むため、全員の振り分けを待つ
+            barrier.arrive_and_wait();
+            std::swap(source, destination);
+        }
+
+        // 振り分けの回数が奇数なら結果は補助配列にあるため、自分の区間を元の配列に書き戻す
+        if (source != data) {
+            std::move(source + bounds[t], source + bounds[t + 1], data + bounds[t]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < num_threads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// 要素の型 T を projection で写したキーを compare の順に並べる並べ替えを、基数ソートで実現できるかを表します。
+// キーが整数か float/double で、compare が std::less (昇順) か std::greater (降順) のときに supported が true です。
+template <typename T, typename Compare, typename Projection>
+struct RadixDispatch {
+    typedef typename std::decay<decltype(std::invoke(std::declval<Projection&>(), std::declval<const T&>()))>::type Key;
+    static constexpr bool supported = RadixKey<Key>::supported && RadixOrder<Compare, Key>::supported;
+    static constexpr bool descending = RadixOrder<Compare, Key>::descending;
+};
+
+#endif
@@ -0,0 +1,200 @@
+// C++
+// 配列の並び替え: 基数ソート (Radix Sort)
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <utility>
+#include <string>
+#include <random>
+
+#include "../../sort_merge/src/AdaptiveMergeSort.h"
+#include "RadixSort.h"
+
+// 要素の型 T の配列を、要素を projection で写したキーの compare の順に安定に並べ替えます。
+// キーが整数か float/double で、compare が std::less (昇順) か std::greater (降順) のときは基数ソートを、
+// それ以外のときは比較によるソート (マージソートのデモと同じ適応的マージソート) を、コンパイル時に選びます。
+// 例えば BasicArrayData<Record, std::greater<>, int Record::*> は、Record を key の降順に基数ソートで並べ替えます。
+template <typename T = int, typename Compare = std::less<>, typename Projection = IdentityProjection>
+class BasicArrayData {
+private:
+    typedef RadixDispatch<T, Compare, Projection> Dispatch;
+
+    std::vector<T> _data;
+    ProjectedLess<Compare, Projection> _less;
+
+public:
+    BasicArrayData(Compare compare = Compare(), Projection projection = Projection())
+        : _less{compare, projection} {}
+
+    std::vector<T> get() {
+        return _data;
+    }
+
+    bool set(const std::vector<T>& data) {
+        _data = data;
+        return true;
+    }
+
+    bool sort() {
+        if constexpr (Dispatch::supported) {
+            radix_sort(_data.data(), _data.size(), 0, _less.projection, Dispatch::descending);
+        } else {
+            adaptive_merge_sort(_data.data(), _data.size(), _less);
+        }
+        return true;
+    }
+};
+
+typedef BasicArrayData<int> ArrayData;
+
+// キーを持つレコード (BasicArrayData の例で使います)。
+// デフォルトコンストラクターを持たない型でも並べ替えられることを確かめるため、コンストラクターを定義します。
+struct Record {
+    std::string name;
+    int key;
+
+    Record(std::string name, int key) : name(std::move(name)), key(key) {}
+};
+
+void printVector(const std::vector<int>& vec) {
+    std::cout << "  [";
+    for (size_t i = 0; i < vec.size(); i++) {
+        std::cout << vec[i];
+        if (i < vec.size() - 1) {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+}
+
+int main() {
+    std::cout << "RadixSort TEST -----> start" << std::endl;
+
+    ArrayData array_data;
+
+    // ランダムな整数の配列
+    std::cout << "\nsort" << std::endl;
+    std::vector<int> input1 = {64, 34, 25, 12, 22, 11, 90};
+    std::cout << "  ソート前: ";
+    printVector(input1);
+    array_data.set(input1);
+    array_data.sort();
+    std::cout << "  ソート後: ";
+    printVector(array_data.get());
+
+    // 既にソートされている配列
+    std::cout << "\nsort" << std::endl;
+    std::vector<int> input2 = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    std::cout << "  ソート前: ";
+    printVector(input2);
+    array_data.set(input2);
+    array_data.sort();
+    std::cout << "  ソート後: ";
+    printVector(array_data.get());
+
+    // 逆順の配列
+    std::cout << "\nsort" << std::endl;
+    std::vector<int> input3 = {10, 9, 8, 7, 6, 5, 4, 3, 2, 1};
+    std::cout << "  ソート前: ";
+    printVector(input3);
+    array_data.set(input3);
+    array_data.sort();
+    std::cout << "  ソート後: ";
+    printVector(array_data.get());
+
+    // 重複要素を含む配列
+    std::cout << "\nsort" << std::endl;
+    std::vector<int> input4 = {10, 9, 8, 7, 6, 10, 9, 8, 7, 6};
+    std::cout << "  ソート前: ";
+    printVector(input4);
+    array_data.set(input4);
+    array_data.sort();
+    std::cout << "  ソート後: ";
+    printVector(array_data.get());
+
+    // 負の数を含む配列
+    std::cout << "\nsort" << std::endl;
+    std::vector<int> input5 = {3, -1, 2147483647, -2147483647 - 1, 0, -100, 100};
+    std::cout << "  ソート前: ";
+    printVector(input5);
+    array_data.set(input5);
+    array_data.sort();
+    std::cout << "  ソート後: ";
+    printVector(array_data.get());
+
+    // 空の配列
+    std::cout << "\nsort" << std::endl;
+    std::vector<int> input6 = {};
+    std::cout << "  ソート前: ";
+    printVector(input6);
+    array_data.set(input6);
+    array_data.sort();
+    std::cout << "  ソート後: ";
+    printVector(array_data.get());
+
+    // 64ビット整数の配列
+    std::cout << "\nradix_sort (64ビット)" << std::endl;
+    std::vector<long long> input7 = {5000000000LL, -5000000000LL, 42, -42, 0};
+    radix_sort(input7.data(), input7.size());
+    std::cout << "  ソート後:   [";
+    for (size_t i = 0; i < input7.size(); i++) {
+        std::cout << input7[i] << (i + 1 < input7.size() ? ", " : "");
+    }
+    std::cout << "]" << std::endl;
+
+    // 浮動小数点数の配列を降順に並べ替える
+    std::cout << "\nsort (double, 降順)" << std::endl;
+    BasicArrayData<double, std::greater<>> double_data;
+    double_data.set({2.5, -0.5, 1e10, -3.25, 0.0, -1e-10, 7.0});
+    double_data.sort();
+    std::cout << "  ソート後:   [";
+    std::vector<double> sorted8 = double_data.get();
+    for (size_t i = 0; i < sorted8.size(); i++) {
+        std::cout << sorted8[i] << (i + 1 < sorted8.size() ? ", " : "");
+    }
+    std::cout << "]" << std::endl;
+
+    // レコードを、int の配列に写さずにメンバー key の降順で並べ替える (key が等しいレコードは元の順序のまま)
+    std::cout << "\nsort (Record, key の降順)" << std::endl;
+    BasicArrayData<Record, std::greater<>, int Record::*> record_data(std::greater<>(), &Record::key);
+    record_data.set({{"alice", 72}, {"bob", 95}, {"carol", 60}, {"dave", 88}, {"eve", 95}});
+    record_data.sort();
+    for (const Record& record : record_data.get()) {
+        std::cout << "  " << record.name << ": " << record.key << std::endl;
+    }
+
+    // キーが文字列のときは基数ソートを使えないため、適応的マージソートで name の昇順に並べ替える
+    std::cout << "\nsort (Record, name の昇順)" << std::endl;
+    BasicArrayData<Record, std::less<>, std::string Record::*> name_data(std::less<>(), &Record::name);
+    name_data.set({{"dave", 88}, {"bob", 95}, {"eve", 95}, {"alice", 72}, {"carol", 60}});
+    name_data.sort();
+    for (const Record& record : name_data.get()) {
+        std::cout << "  " << record.name << ": " << record.key << std::endl;
+    }
+
+    // -0.0 と 0.0 を含む浮動小数点数を、基数ソートと比較によるソートで並べ替えた結果 (符号も含めて) を比べる
+    std::cout << "\nradix_sort (±0.0)" << std::endl;
+    std::mt19937 rng(1);
+    const double samples[] = {-0.0, 0.0, -1.5, 1.5, -1e-300, 1e-300};
+    int mismatches = 0;
+    for (int trial = 0; trial < 1000; ++trial) {
+        std::vector<double> values(1 + rng() % 200);
+        for (double& value : values) {
+            value = samples[rng() % 6];
+        }
+        std::vector<double> expected = values;
+        adaptive_merge_sort(expected.data(), expected.size(), std::less<>());
+        radix_sort(values.data(), values.size());
+        if (std::memcmp(values.data(), expected.data(), values.size() * sizeof(double)) != 0) {
+            ++mismatches;
+        }
+    }
+    std::cout << "  比較によるソートと異なる結果の数: " << mismatches << std::endl;
+
+    std::cout << "\nRadixSort TEST <----- end" << std::endl;
+
+    return 0;
+}
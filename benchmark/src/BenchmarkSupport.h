@@ -0,0 +1,202 @@
+// C++
+// ベンチマークの共通部品: メモリ確保回数の計測と、アルゴリズムごとの最大常駐メモリ (peak RSS) の計測
+//
+// グローバルな operator new/delete を置き換えるため、1つのプログラムで1回だけ取り込んでください。
+
+#ifndef BENCHMARK_SUPPORT_H
+#define BENCHMARK_SUPPORT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// operator new を置き換えて、メモリ確保の回数を数えます。
+// 通常版・配列版・nothrow 版・アライメント指定版の new と、それぞれに対応する delete をすべて置き換えます。
+// (delete を呼び出し元に展開させると、GCC が「operator new の結果を free で解放している」と
+//  -Wmismatched-new-delete を出すため、new/delete は展開しません)
+std::atomic<unsigned long long> allocation_count(0);
+
+__attribute__((noinline)) void* counted_allocate(std::size_t size) noexcept {
+    ++allocation_count;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+__attribute__((noinline)) void* counted_allocate(std::size_t size, std::align_val_t alignment) noexcept {
+    ++allocation_count;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (align < sizeof(void*)) {
+        align = sizeof(void*);
+    }
+    void* pointer = nullptr;
+    return posix_memalign(&pointer, align, size == 0 ? 1 : size) == 0 ? pointer : nullptr;
+}
+
+__attribute__((noinline)) void counted_release(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    if (void* pointer = counted_allocate(size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new[](std::size_t size) {
+    if (void* pointer = counted_allocate(size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_allocate(size);
+}
+
+__attribute__((noinline)) void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_allocate(size);
+}
+
+__attribute__((noinline)) void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* pointer = counted_allocate(size, alignment)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new[](std::size_t size, std::align_val_t alignment) {
+    if (void* pointer = counted_allocate(size, alignment)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_allocate(size, alignment);
+}
+
+__attribute__((noinline)) void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_allocate(size, alignment);
+}
+
+__attribute__((noinline)) void operator delete(void* pointer) noexcept {
+    counted_release(pointer);
+}
+
+__attribute__((noinline)) void operator delete[](void* pointer) noexcept {
+    counted_release(pointer);
+}
+
+__attribute__((noinline)) void operator delete(void* pointer, std::size_t) noexcept {
+    counted_release(pointer);
+}
+
+__attribute__((noinline)) void operator delete[](void* pointer, std::size_t) noexcept {
+    counted_release(pointer);
+}
+
+__attribute__((noinline)) void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    counted_release(pointer);
+}
+
+__attribute__((noinline)) void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    counted_release(pointer);
+}
+
+__attribute__((noinline)) void operator delete(void* pointer, std::align_val_t) noexcept {
+    counted_release(pointer);
+}
+
+__attribute__((noinline)) void operator delete[](void* pointer, std::align_val_t) noexcept {
+    counted_release(pointer);
+}
+
+__attribute__((noinline)) void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    counted_release(pointer);
+}
+
+__attribute__((noinline)) void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+    counted_release(pointer);
+}
+
+__attribute__((noinline)) void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    counted_release(pointer);
+}
+
+__attribute__((noinline)) void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    counted_release(pointer);
+}
+
+// 1回の計測の結果
+struct Measurement {
+    double seconds;
+    unsigned long long allocations;
+    // 結果の確認 (ソートの結果が正しいかなど) に通ったか
+    bool ok;
+    long peak_rss_kb;
+};
+
+// run() の実行時間とメモリ確保回数を計測します。run() は結果の確認に通ったかを返します。
+// 計測中はデモのアルゴリズムが出力するメッセージを表示しません。
+template <typename Run>
+Measurement measure_run(Run run) {
+    std::cout.setstate(std::ios::failbit);
+    unsigned long long allocations_before = allocation_count.load();
+    auto start = std::chrono::steady_clock::now();
+    bool ok = run();
+    auto end = std::chrono::steady_clock::now();
+    unsigned long long allocations = allocation_count.load() - allocations_before;
+    std::cout.clear();
+    return Measurement{std::chrono::duration<double>(end - start).count(), allocations, ok, 0};
+}
+
+// task() (Measurement を返す) を fork した子プロセスで実行し、その結果に子プロセスの最大常駐メモリ (KB) を加えて返します。
+// ru_maxrss はプロセスの最大値で減ることがないため、同じプロセスで続けて計測すると、
+// それまでに最もメモリを使ったアルゴリズムの値になってしまいます。アルゴリズムごとに子プロセスを分けることで、
+// 値は「fork 時点の常駐メモリ (入力データなど、全アルゴリズムで共通) + そのアルゴリズムの使用量」になります。
+// fork できない場合は同じプロセスで実行し、プロセス全体の値を返します。
+template <typename Task>
+Measurement measure_in_child(Task task) {
+    std::cout.flush();
+    int fds[2];
+    if (pipe(fds) == 0) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            Measurement measurement = task();
+            ssize_t written = write(fds[1], &measurement, sizeof(measurement));
+            _exit(written == static_cast<ssize_t>(sizeof(measurement)) ? 0 : 1);
+        }
+        close(fds[1]);
+        if (pid > 0) {
+            Measurement measurement = {};
+            ssize_t received = read(fds[0], &measurement, sizeof(measurement));
+            close(fds[0]);
+            int status = 0;
+            struct rusage usage;
+            if (wait4(pid, &status, 0, &usage) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+                received == static_cast<ssize_t>(sizeof(measurement))) {
+                measurement.peak_rss_kb = usage.ru_maxrss;
+                return measurement;
+            }
+            std::cerr << "ERROR: 計測用の子プロセスが異常終了しました。" << std::endl;
+            return Measurement{0.0, 0, false, 0};
+        }
+        close(fds[0]);
+    }
+
+    Measurement measurement = task();
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    measurement.peak_rss_kb = usage.ru_maxrss;
+    return measurement;
+}
+
+#endif
@@ -0,0 +1,724 @@
+// C++
+// グラフアルゴリズムのベンチマーク
+//
+// 合成グラフ (格子、ランダム幾何グラフ、R-MAT、Erdős–Rényi) を生成し、各デモのアルゴリズムの
+// 実行時間・辺/秒・最大常駐メモリ (peak RSS)・メモリ確保回数を JSON で出力します。
+// 各アルゴリズムは fork した子プロセスで実行し、peak RSS はその子プロセスの値を記録します。
+// 各アルゴリズムの出力はベンチマーク側で求めた正解と照らし合わせて "ok" に記録し、
+// 一致しない計測が1つでもあれば終了コード 1 で終わります。
+//
+// ビルドと実行の例:
+//   g++ -std=c++17 -O2 -pthread benchmark/src/GraphBenchmark.cpp -o graph_benchmark
+//   ./graph_benchmark --generator all --vertices 4096 --edge-factor 8 --seed 1
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <queue>
+#include <stack>
+#include <set>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <stdexcept>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+#include "BenchmarkSupport.h"
+#include "../../graph_shortest_path/common/src/CheckedArithmetic.h"
+#include "../../graph_components/common/src/CsrTraversal.h"
+
+// 各デモは1つのファイルで完結しているため、名前空間に分けてそのまま取り込みます。
+// 標準ヘッダーと、デモが共有するヘッダーは上で先に取り込んでおき、デモの main() は別名にします。
+#define main demo_main
+namespace dijkstra {
+#include "../../graph_shortest_path/dijkstra/src/DijkstraDemo.cpp"
+}
+namespace a_star {
+#include "../../graph_shortest_path/a_start/src/AStartDemo.cpp"
+}
+namespace bellman_ford {
+#include "../../graph_shortest_path/bellman_ford/src/BellmanFordDemo.cpp"
+}
+namespace floyd_warshall {
+#include "../../graph_shortest_path/floyd_warshall/src/WarshallFloydDemo.cpp"
+}
+namespace prims {
+#include "../../graph_mst/prims/src/PrimsDemo.cpp"
+}
+namespace kruskal {
+#include "../../graph_mst/kruskal/src/KruskalDemo.cpp"
+}
+namespace bfs {
+#include "../../graph_components/bfs/src/BfsDemo.cpp"
+}
+namespace dfs {
+#include "../../graph_components/dfs/src/DfsDemo.cpp"
+}
+namespace union_find {
+#include "../../graph_components/union_find/src/UnionFind.cpp"
+}
+#undef main
+
+// 生成したグラフの辺 (頂点は 0..num_vertices-1 の整数)
+struct Edge {
+    int u;
+    int v;
+    int weight;
+};
+
+struct SyntheticGraph {
+    std::string generator;
+    int num_vertices;
+    std::vector<Edge> edges;
+};
+
+// 辺の重みは 1..100 の一様乱数です。
+int random_weight(std::mt19937_64& rng) {
+    return static_cast<int>(rng() % 100) + 1;
+}
+
+// 格子グラフ: side x side の格子で、上下左右の隣接セルを辺で結びます。
+SyntheticGraph generate_grid(int num_vertices, std::mt19937_64& rng) {
+    int side = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(num_vertices))));
+    SyntheticGraph graph{"grid", side * side, {}};
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            int u = y * side + x;
+            if (x + 1 < side) {
+                graph.edges.push_back(Edge{u, u + 1, random_weight(rng)});
+            }
+            if (y + 1 < side) {
+                graph.edges.push_back(Edge{u, u + side, random_weight(rng)});
+            }
+        }
+    }
+    return graph;
+}
+
+// ランダム幾何グラフ: 単位正方形に点を置き、距離が半径 r 以内の点の組を辺で結びます。
+// 平均次数が約 2 * edge_factor になるように r を決め、r 四方のセルに分けて近傍だけを調べます。
+SyntheticGraph generate_geometric(int num_vertices, int edge_factor, std::mt19937_64& rng) {
+    SyntheticGraph graph{"geometric", num_vertices, {}};
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<std::pair<double, double>> points(num_vertices);
+    for (auto& point : points) {
+        point = std::make_pair(uniform(rng), uniform(rng));
+    }
+    const double radius = std::sqrt(2.0 * edge_factor / (M_PI * num_vertices));
+    const int cells = std::max(1, static_cast<int>(1.0 / radius));
+    std::vector<std::vector<int>> buckets(static_cast<size_t>(cells) * cells);
+    auto cell_of = [cells](double coordinate) {
+        return std::min(cells - 1, static_cast<int>(coordinate * cells));
+    };
+    for (int i = 0; i < num_vertices; ++i) {
+        buckets[cell_of(points[i].second) * cells + cell_of(points[i].first)].push_back(i);
+    }
+    for (int u = 0; u < num_vertices; ++u) {
+        int cx = cell_of(points[u].first);
+        int cy = cell_of(points[u].second);
+        for (int y = std::max(0, cy - 1); y <= std::min(cells - 1, cy + 1); ++y) {
+            for (int x = std::max(0, cx - 1); x <= std::min(cells - 1, cx + 1); ++x) {
+                for (int v : buckets[y * cells + x]) {
+                    double dx = points[u].first - points[v].first;
+                    double dy = points[u].second - points[v].second;
+                    if (u < v && dx * dx + dy * dy <= radius * radius) {
+                        graph.edges.push_back(Edge{u, v, random_weight(rng)});
+                    }
+                }
+            }
+        }
+    }
+    return graph;
+}
+
+// R-MAT (Kronecker) グラフ: 隣接行列を再帰的に4分割し、確率 (a, b, c, d) で区画を選んで辺を置きます。
+// 次数がべき乗則に従うグラフになります。頂点数は2のべき乗に切り上げます。
+SyntheticGraph generate_rmat(int num_vertices, int edge_factor, std::mt19937_64& rng) {
+    int scale = 0;
+    while ((1 << scale) < num_vertices) {
+        ++scale;
+    }
+    SyntheticGraph graph{"rmat", 1 << scale, {}};
+    const double a = 0.57;
+    const double b = 0.19;
+    const double c = 0.19;
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const long long num_edges = static_cast<long long>(edge_factor) * graph.num_vertices;
+    for (long long i = 0; i < num_edges; ++i) {
+        int u = 0;
+        int v = 0;
+        for (int bit = 0; bit < scale; ++bit) {
+            double r = uniform(rng);
+            if (r < a) {
+                // 左上
+            } else if (r < a + b) {
+                v |= 1 << bit;
+            } else if (r < a + b + c) {
+                u |= 1 << bit;
+            } else {
+                u |= 1 << bit;
+                v |= 1 << bit;
+            }
+        }
+        if (u != v) {
+            graph.edges.push_back(Edge{u, v, random_weight(rng)});
+        }
+    }
+    return graph;
+}
+
+// Erdős–Rényi グラフ G(n, m): m = edge_factor * n 本の辺を一様ランダムな頂点の組に置きます。
+SyntheticGraph generate_erdos_renyi(int num_vertices, int edge_factor, std::mt19937_64& rng) {
+    SyntheticGraph graph{"erdos_renyi", num_vertices, {}};
+    const long long num_edges = static_cast<long long>(edge_factor) * num_vertices;
+    for (long long i = 0; i < num_edges; ++i) {
+        int u = static_cast<int>(rng() % num_vertices);
+        int v = static_cast<int>(rng() % num_vertices);
+        if (u != v) {
+            graph.edges.push_back(Edge{u, v, random_weight(rng)});
+        }
+    }
+    return graph;
+}
+
+// 頂点名 (デモの GraphData は文字列の頂点を扱います)
+std::vector<std::string> vertex_names(int num_vertices) {
+    std::vector<std::string> names(num_vertices);
+    for (int i = 0; i < num_vertices; ++i) {
+        names[i] = "v" + std::to_string(i);
+    }
+    return names;
+}
+
+// 計測したアルゴリズムの出力を確かめるための正解です。ベンチマーク側で、デモとは別に求めます。
+// デモの add_edge は無向辺を追加し、同じ頂点の組の辺を追加し直すと重みを上書きするため、正解も同じ規則で作ります。
+struct GraphReference {
+    std::unordered_map<std::string, int> ids;          // 頂点名 -> 頂点
+    std::map<std::pair<int, int>, int> weights;        // 無向辺 (小さい頂点, 大きい頂点) -> 重み
+    std::vector<bool> present;                          // 辺の端点として GraphData に入る頂点か
+    std::vector<int> component;                         // 頂点 -> 連結成分の代表の頂点
+    std::map<int, int> component_sizes;                 // 連結成分の代表 -> 頂点数
+    std::map<int, long long> component_mst_weights;     // 連結成分の代表 -> 最小全域木の重み
+    long long distance;                                 // 始点から終点までの最短距離 (到達できなければ -1)
+
+    int find(int vertex) {
+        while (component[vertex] != vertex) {
+            component[vertex] = component[component[vertex]];
+            vertex = component[vertex];
+        }
+        return vertex;
+    }
+
+    // 頂点名 name の辺 (u, name) の重みを weight に入れます。辺がなければ false を返します。
+    bool edge_weight(int u, const std::string& name, int& weight) const {
+        auto id = ids.find(name);
+        if (id == ids.end()) {
+            return false;
+        }
+        auto it = weights.find(std::make_pair(std::min(u, id->second), std::max(u, id->second)));
+        if (it == weights.end()) {
+            return false;
+        }
+        weight = it->second;
+        return true;
+    }
+};
+
+// グラフの正解 (連結成分、連結成分ごとの最小全域木の重み、source から target までの最短距離) を求めます。
+GraphReference build_reference(const SyntheticGraph& graph, const std::vector<std::string>& names,
+                               int source, int target) {
+    GraphReference reference;
+    for (int v = 0; v < graph.num_vertices; ++v) {
+        reference.ids[names[v]] = v;
+    }
+    reference.present.assign(graph.num_vertices, false);
+    for (const Edge& edge : graph.edges) {
+        reference.weights[std::make_pair(std::min(edge.u, edge.v), std::max(edge.u, edge.v))] = edge.weight;
+        reference.present[edge.u] = true;
+        reference.present[edge.v] = true;
+    }
+
+    // クラスカル法で連結成分と最小全域木の重みを求める
+    std::vector<std::pair<int, std::pair<int, int>>> sorted_edges;
+    for (const auto& edge : reference.weights) {
+        sorted_edges.push_back(std::make_pair(edge.second, edge.first));
+    }
+    std::sort(sorted_edges.begin(), sorted_edges.end());
+    reference.component.resize(graph.num_vertices);
+    std::iota(reference.component.begin(), reference.component.end(), 0);
+    std::vector<long long> tree_weights(graph.num_vertices, 0);
+    for (const auto& edge : sorted_edges) {
+        int a = reference.find(edge.second.first);
+        int b = reference.find(edge.second.second);
+        if (a != b) {
+            reference.component[a] = b;
+            tree_weights[b] += tree_weights[a] + edge.first;
+        }
+    }
+    // 各頂点から代表の頂点を直接引けるようにする
+    for (int v = 0; v < graph.num_vertices; ++v) {
+        int root = reference.find(v);
+        reference.component[v] = root;
+        if (reference.present[v]) {
+            ++reference.component_sizes[root];
+            reference.component_mst_weights[root] = tree_weights[root];
+        }
+    }
+
+    // ダイクストラ法で最短距離を求める
+    std::vector<std::vector<std::pair<int, int>>> adjacency(graph.num_vertices);
+    for (const auto& edge : reference.weights) {
+        adjacency[edge.first.first].push_back(std::make_pair(edge.first.second, edge.second));
+        adjacency[edge.first.second].push_back(std::make_pair(edge.first.first, edge.second));
+    }
+    std::vector<long long> distances(graph.num_vertices, -1);
+    std::priority_queue<std::pair<long long, int>, std::vector<std::pair<long long, int>>,
+                        std::greater<std::pair<long long, int>>> queue;
+    distances[source] = 0;
+    queue.push(std::make_pair(0LL, source));
+    while (!queue.empty()) {
+        std::pair<long long, int> top = queue.top();
+        queue.pop();
+        if (top.first != distances[top.second]) {
+            continue;
+        }
+        for (const auto& neighbor : adjacency[top.second]) {
+            long long distance = top.first + neighbor.second;
+            if (distances[neighbor.first] == -1 || distance < distances[neighbor.first]) {
+                distances[neighbor.first] = distance;
+                queue.push(std::make_pair(distance, neighbor.first));
+            }
+        }
+    }
+    reference.distance = distances[target];
+    return reference;
+}
+
+// path が source から target への、辺をたどれる経路で、重みの合計が cost かを確かめます。
+template <typename Distance>
+bool check_path(const GraphReference& reference, const std::string& source, const std::string& target,
+                const std::vector<std::string>& path, Distance cost) {
+    if (path.empty() || path.front() != source || path.back() != target) {
+        return false;
+    }
+    long long total = 0;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        auto id = reference.ids.find(path[i]);
+        int weight = 0;
+        if (id == reference.ids.end() || !reference.edge_weight(id->second, path[i + 1], weight)) {
+            return false;
+        }
+        total += weight;
+    }
+    return static_cast<Distance>(total) == cost;
+}
+
+// 最短経路の問い合わせの結果 (経路, 距離) が正解と一致するかを確かめます。
+template <typename Distance>
+bool check_shortest_path(const GraphReference& reference, const std::string& source, const std::string& target,
+                         const std::pair<std::vector<std::string>, Distance>& result) {
+    if (reference.distance < 0) {
+        return result.first.empty();
+    }
+    return static_cast<Distance>(reference.distance) == result.second &&
+           check_path(reference, source, target, result.first, result.second);
+}
+
+// 短い順の k 本の経路が、それぞれ正しい経路で、互いに異なり、距離の短い順に並び、先頭が最短経路かを確かめます。
+template <typename Distance>
+bool check_k_shortest_paths(const GraphReference& reference, const std::string& source, const std::string& target,
+                            const std::vector<std::pair<std::vector<std::string>, Distance>>& paths) {
+    if (reference.distance < 0) {
+        return paths.empty();
+    }
+    if (paths.empty() || static_cast<Distance>(reference.distance) != paths.front().second) {
+        return false;
+    }
+    std::set<std::vector<std::string>> distinct;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (!check_path(reference, source, target, paths[i].first, paths[i].second) ||
+            (i > 0 && paths[i].second < paths[i - 1].second) || !distinct.insert(paths[i].first).second) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 最小全域木 (または全域森) の辺が閉路を作らず、覆う連結成分ごとに全頂点をつなぎ、重みが最小かを確かめます。
+// all_components が true なら、すべての連結成分を覆っていることも確かめます (クラスカル法)。
+// false なら、ちょうど1つの連結成分を覆っていることを確かめます (1つの頂点から始めるプリム法)。
+template <typename Weight>
+bool check_mst(const GraphReference& reference, const std::vector<std::tuple<std::string, std::string, Weight>>& mst,
+               bool all_components) {
+    std::vector<int> parent(reference.component.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](int vertex) {
+        while (parent[vertex] != vertex) {
+            parent[vertex] = parent[parent[vertex]];
+            vertex = parent[vertex];
+        }
+        return vertex;
+    };
+    std::map<int, int> edge_counts;
+    std::map<int, long long> tree_weights;
+    for (const auto& edge : mst) {
+        auto u = reference.ids.find(std::get<0>(edge));
+        int weight = 0;
+        if (u == reference.ids.end() || !reference.edge_weight(u->second, std::get<1>(edge), weight) ||
+            static_cast<Weight>(weight) != std::get<2>(edge)) {
+            return false;
+        }
+        int v = reference.ids.at(std::get<1>(edge));
+        if (find(u->second) == find(v)) {
+            return false;
+        }
+        parent[find(u->second)] = find(v);
+        int root = reference.component[u->second];
+        ++edge_counts[root];
+        tree_weights[root] += weight;
+    }
+    if (all_components ? edge_counts.size() != reference.component_sizes.size() : edge_counts.size() != 1) {
+        return false;
+    }
+    for (const auto& count : edge_counts) {
+        if (count.second != reference.component_sizes.at(count.first) - 1 ||
+            tree_weights[count.first] != reference.component_mst_weights.at(count.first)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 頂点名の連結成分の一覧が、正解の連結成分と同じ分け方かを確かめます。
+bool check_components(const GraphReference& reference, const std::vector<std::vector<std::string>>& components) {
+    if (components.size() != reference.component_sizes.size()) {
+        return false;
+    }
+    std::set<int> seen_roots;
+    std::set<int> seen_vertices;
+    for (const auto& component : components) {
+        if (component.empty()) {
+            return false;
+        }
+        auto first = reference.ids.find(component.front());
+        if (first == reference.ids.end()) {
+            return false;
+        }
+        int root = reference.component[first->second];
+        if (!seen_roots.insert(root).second || static_cast<int>(component.size()) != reference.component_sizes.at(root)) {
+            return false;
+        }
+        for (const std::string& name : component) {
+            auto id = reference.ids.find(name);
+            if (id == reference.ids.end() || reference.component[id->second] != root || !seen_vertices.insert(id->second).second) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// CSR の頂点ごとの連結成分番号 (csr_connected_components の結果) が、正解の連結成分と同じ分け方かを確かめます。
+bool check_component_labels(const GraphReference& reference, const std::vector<std::string>& csr_names,
+                            const std::vector<int>& labels) {
+    if (labels.size() != csr_names.size()) {
+        return false;
+    }
+    std::map<int, int> label_of_root;
+    std::map<int, int> root_of_label;
+    for (size_t v = 0; v < labels.size(); ++v) {
+        auto id = reference.ids.find(csr_names[v]);
+        if (id == reference.ids.end()) {
+            return false;
+        }
+        int root = reference.component[id->second];
+        if (label_of_root.emplace(root, labels[v]).first->second != labels[v] ||
+            root_of_label.emplace(labels[v], root).first->second != root) {
+            return false;
+        }
+    }
+    return label_of_root.size() == reference.component_sizes.size();
+}
+
+// 1つのアルゴリズムの計測結果
+struct BenchmarkResult {
+    std::string algorithm;
+    bool skipped;
+    // 出力が正解と一致したか
+    bool ok;
+    double seconds;
+    unsigned long long allocations;
+    long peak_rss_kb;
+};
+
+// 子プロセスでグラフを GraphData に読み込んで prepare(graph_data) を実行し (ここまでは計測しない)、
+// run(graph_data) の実行時間・メモリ確保回数と、子プロセスの最大常駐メモリを計測します。
+// run の戻り値 (アルゴリズムの出力) を check に渡し、正解と一致するかも確認します (確認にかかる時間は計測しません)。
+// デモのアルゴリズムが出力するメッセージは表示しません。
+template <typename Graph, typename Prepare, typename Run, typename Check>
+BenchmarkResult measure(const std::string& algorithm, const SyntheticGraph& graph,
+                        const std::vector<std::string>& names, Prepare prepare, Run run, Check check) {
+    Measurement measurement = measure_in_child([&]() {
+        Graph graph_data;
+        for (const Edge& edge : graph.edges) {
+            graph_data.add_edge(names[edge.u], names[edge.v], edge.weight);
+        }
+        std::cout.setstate(std::ios::failbit);
+        prepare(graph_data);
+        std::cout.clear();
+
+        decltype(run(graph_data)) output{};
+        Measurement run_measurement = measure_run([&]() {
+            output = run(graph_data);
+            return true;
+        });
+        run_measurement.ok = check(output);
+        return run_measurement;
+    });
+    return BenchmarkResult{algorithm, false, measurement.ok, measurement.seconds, measurement.allocations,
+                           measurement.peak_rss_kb};
+}
+
+template <typename Graph, typename Run, typename Check>
+BenchmarkResult measure(const std::string& algorithm, const SyntheticGraph& graph,
+                        const std::vector<std::string>& names, Run run, Check check) {
+    return measure<Graph>(algorithm, graph, names, [](Graph&) {}, run, check);
+}
+
+// 1つのグラフに対してすべてのアルゴリズムを計測し、出力をベンチマーク側で求めた正解と照らし合わせます。
+std::vector<BenchmarkResult> run_all(const SyntheticGraph& graph, int max_floyd_vertices) {
+    std::vector<std::string> names = vertex_names(graph.num_vertices);
+    // 孤立した頂点は GraphData に追加されないため、最短経路の始点と終点は辺の端点から選ぶ
+    const std::string& source = names[graph.edges.front().u];
+    const std::string& target = names[graph.edges.back().v];
+    GraphReference reference = build_reference(graph, names, graph.edges.front().u, graph.edges.back().v);
+    auto shortest_path_ok = [&](const auto& result) {
+        return check_shortest_path(reference, source, target, result);
+    };
+    auto components_ok = [&](const std::vector<std::vector<std::string>>& components) {
+        return check_components(reference, components);
+    };
+    std::vector<BenchmarkResult> results;
+
+    results.push_back(measure<dijkstra::GraphData>("dijkstra", graph, names, [&](dijkstra::GraphData& g) {
+        return g.get_shortest_path(source, target, dijkstra::dummy_heuristic);
+    }, shortest_path_ok));
+    results.push_back(measure<a_star::GraphData>("a_star", graph, names, [&](a_star::GraphData& g) {
+        return g.get_shortest_path(source, target, a_star::dummy_heuristic);
+    }, shortest_path_ok));
+    results.push_back(measure<bellman_ford::GraphData>("bellman_ford", graph, names, [&](bellman_ford::GraphData& g) {
+        return g.get_shortest_path(source, target, bellman_ford::dummy_heuristic);
+    }, shortest_path_ok));
+    // ワーシャル-フロイド法は O(V^3) のため、頂点数が多いグラフでは計測しない
+    if (graph.num_vertices <= max_floyd_vertices) {
+        results.push_back(measure<floyd_warshall::GraphData>("floyd_warshall", graph, names, [&](floyd_warshall::GraphData& g) {
+            return g.get_shortest_path(source, target, floyd_warshall::dummy_heuristic);
+        }, shortest_path_ok));
+    } else {
+        results.push_back(BenchmarkResult{"floyd_warshall", true, false, 0.0, 0, 0});
+    }
+    results.push_back(measure<prims::GraphData>("prim", graph, names, [&](prims::GraphData& g) {
+        return g.get_mst();
+    }, [&](const auto& mst) {
+        return check_mst(reference, mst, false);
+    }));
+    results.push_back(measure<kruskal::GraphData>("kruskal", graph, names, [&](kruskal::GraphData& g) {
+        return g.get_mst();
+    }, [&](const auto& mst) {
+        return check_mst(reference, mst, true);
+    }));
+    results.push_back(measure<bfs::GraphData>("bfs", graph, names, [&](bfs::GraphData& g) {
+        return g.get_connected_components();
+    }, components_ok));
+    results.push_back(measure<dfs::GraphData>("dfs", graph, names, [&](dfs::GraphData& g) {
+        return g.get_connected_components();
+    }, components_ok));
+    results.push_back(measure<union_find::GraphData>("union_find", graph, names, [&](union_find::GraphData& g) {
+        return g.get_connected_components();
+    }, components_ok));
+
+    // 頂点IDの振り方ごとの探索時間 (CSR の作成は計測しない)
+    const std::vector<std::tuple<std::string, dijkstra::VertexOrder, bfs::VertexOrder>> orders = {
+        std::make_tuple("name", dijkstra::VertexOrder::Name, bfs::VertexOrder::Name),
+        std::make_tuple("bfs", dijkstra::VertexOrder::Bfs, bfs::VertexOrder::Bfs),
+        std::make_tuple("rcm", dijkstra::VertexOrder::Rcm, bfs::VertexOrder::Rcm),
+        std::make_tuple("degree", dijkstra::VertexOrder::Degree, bfs::VertexOrder::Degree)
+    };
+    for (const auto& order : orders) {
+        const std::string& order_name = std::get<0>(order);
+        results.push_back(measure<dijkstra::GraphData>("dijkstra_csr_" + order_name, graph, names,
+            [&](dijkstra::GraphData& g) {
+                g.set_vertex_order(std::get<1>(order));
+                g.get_csr();
+            },
+            [&](dijkstra::GraphData& g) {
+                return g.get_shortest_path(source, target, dijkstra::dummy_heuristic);
+            }, shortest_path_ok));
+        CsrGraph csr;
+        results.push_back(measure<bfs::GraphData>("bfs_csr_" + order_name, graph, names,
+            [&](bfs::GraphData& g) {
+                csr = g.build_csr(std::get<2>(order));
+            },
+            [&](bfs::GraphData&) {
+                return bfs::csr_connected_components(csr);
+            },
+            [&](const std::vector<int>& labels) {
+                return check_component_labels(reference, csr.names, labels);
+            }));
+    }
+
+    // 圧縮した隣接表現 (幅優先順のID) での探索時間
+    dijkstra::CompressedCsrGraph dijkstra_compressed;
+    dijkstra::SearchWorkspace workspace;
+    results.push_back(measure<dijkstra::GraphData>("dijkstra_compressed", graph, names,
+        [&](dijkstra::GraphData& g) {
+            g.set_vertex_order(dijkstra::VertexOrder::Bfs);
+            dijkstra_compressed = g.build_compressed_csr();
+            workspace.reset(dijkstra_compressed.num_vertices());
+        },
+        [&](dijkstra::GraphData&) {
+            return dijkstra::csr_shortest_path(dijkstra_compressed, source, target, dijkstra::dummy_heuristic, workspace);
+        }, shortest_path_ok));
+    // 重みを unsigned short、距離を unsigned int にした CSR での探索時間 (重みはすべて 1〜100)
+    dijkstra::BasicCsrGraph<unsigned short> dijkstra_compact;
+    dijkstra::BasicSearchWorkspace<unsigned int> compact_workspace;
+    results.push_back(measure<dijkstra::GraphData>("dijkstra_csr_u16", graph, names,
+        [&](dijkstra::GraphData& g) {
+            dijkstra::convert_csr_weights(g.get_csr(), dijkstra_compact);
+            compact_workspace.reset(dijkstra_compact.num_vertices());
+        },
+        [&](dijkstra::GraphData&) {
+            return dijkstra::csr_shortest_path(dijkstra_compact, source, target, dijkstra::dummy_heuristic, compact_workspace);
+        }, shortest_path_ok));
+    // Yen のアルゴリズムで短い順に10本の経路を求める1回の問い合わせの時間 (CSR の作成は計測しない)
+    results.push_back(measure<dijkstra::GraphData>("dijkstra_k_shortest_10", graph, names,
+        [&](dijkstra::GraphData& g) {
+            g.get_csr();
+        },
+        [&](dijkstra::GraphData& g) {
+            return g.get_k_shortest_paths(source, target, 10);
+        },
+        [&](const auto& paths) {
+            return check_k_shortest_paths(reference, source, target, paths);
+        }));
+    CompressedCsrGraph bfs_compressed;
+    results.push_back(measure<bfs::GraphData>("bfs_compressed", graph, names,
+        [&](bfs::GraphData& g) {
+            bfs_compressed = g.build_compressed_csr(bfs::VertexOrder::Bfs);
+        },
+        [&](bfs::GraphData&) {
+            return bfs::csr_connected_components(bfs_compressed);
+        },
+        [&](const std::vector<int>& labels) {
+            return check_component_labels(reference, bfs_compressed.names, labels);
+        }));
+    return results;
+}
+
+// 計測結果を JSON で出力します。
+void print_json(const SyntheticGraph& graph, unsigned long long seed,
+                const std::vector<BenchmarkResult>& results, bool last) {
+    std::cout << "  {\"generator\": \"" << graph.generator << "\", \"vertices\": " << graph.num_vertices
+              << ", \"edges\": " << graph.edges.size() << ", \"seed\": " << seed << ", \"results\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& result = results[i];
+        std::cout << "    {\"algorithm\": \"" << result.algorithm << "\"";
+        if (result.skipped) {
+            std::cout << ", \"skipped\": true";
+        } else {
+            double edges_per_second = result.seconds > 0 ? graph.edges.size() / result.seconds : 0.0;
+            std::cout << ", \"skipped\": false, \"ok\": " << (result.ok ? "true" : "false")
+                      << ", \"seconds\": " << result.seconds
+                      << ", \"edges_per_second\": " << edges_per_second
+                      << ", \"allocations\": " << result.allocations
+                      << ", \"peak_rss_kb\": " << result.peak_rss_kb;
+        }
+        std::cout << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    std::cout << "  ]}" << (last ? "" : ",") << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string generator = "all";
+    int num_vertices = 4096;
+    int edge_factor = 8;
+    unsigned long long seed = 1;
+    int max_floyd_vertices = 512;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        std::string value = argv[i + 1];
+        if (option == "--generator") {
+            generator = value;
+        } else if (option == "--vertices") {
+            num_vertices = std::stoi(value);
+        } else if (option == "--edge-factor") {
+            edge_factor = std::stoi(value);
+        } else if (option == "--seed") {
+            seed = std::stoull(value);
+        } else if (option == "--max-floyd-vertices") {
+            max_floyd_vertices = std::stoi(value);
+        } else {
+            std::cerr << "ERROR: 不明なオプション " << option << std::endl;
+            return 1;
+        }
+    }
+    if (num_vertices < 2 || edge_factor < 1) {
+        std::cerr << "ERROR: --vertices は2以上、--edge-factor は1以上を指定してください。" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> generators;
+    if (generator == "all") {
+        generators = {"grid", "geometric", "rmat", "erdos_renyi"};
+    } else {
+        generators = {generator};
+    }
+
+    int num_failed = 0;
+    std::cout << "[" << std::endl;
+    for (size_t i = 0; i < generators.size(); ++i) {
+        std::mt19937_64 rng(seed);
+        SyntheticGraph graph;
+        if (generators[i] == "grid") {
+            graph = generate_grid(num_vertices, rng);
+        } else if (generators[i] == "geometric") {
+            graph = generate_geometric(num_vertices, edge_factor, rng);
+        } else if (generators[i] == "rmat") {
+            graph = generate_rmat(num_vertices, edge_factor, rng);
+        } else if (generators[i] == "erdos_renyi") {
+            graph = generate_erdos_renyi(num_vertices, edge_factor, rng);
+        } else {
+            std::cerr << "ERROR: 不明な生成方法 " << generators[i] << std::endl;
+            return 1;
+        }
+        if (graph.edges.empty()) {
+            std::cerr << "ERROR: 辺が生成されませんでした。" << std::endl;
+            return 1;
+        }
+        std::vector<BenchmarkResult> results = run_all(graph, max_floyd_vertices);
+        for (const BenchmarkResult& result : results) {
+            num_failed += !result.skipped && !result.ok;
+        }
+        print_json(graph, seed, results, i + 1 == generators.size());
+    }
+    std::cout << "]" << std::endl;
+    if (num_failed > 0) {
+        std::cerr << "ERROR: " << num_failed << " 件の計測で、出力が正解と一致しませんでした。" << std::endl;
+        return 1;
+    }
+    return 0;
+}
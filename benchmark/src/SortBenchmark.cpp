@@ -0,0 +1,286 @@
+// C++
+// 配列の並び替えのベンチマーク
+//
+// 入力の並び (ランダム、ソート済み、逆順、重複が多い、ほぼソート済み、末尾への追記) ごとに各デモのソートを実行し、
+// 実行時間・要素/秒・最大常駐メモリ (peak RSS)・メモリ確保回数を JSON で出力します。
+// 各アルゴリズムは fork した子プロセスで実行し、peak RSS はその子プロセスの値を記録します。
+// 並列ソートのスレッド数は --threads で指定します (0 の場合はハードウェアの並列数)。
+//
+// ビルドと実行の例:
+//   g++ -std=c++17 -O2 -pthread benchmark/src/SortBenchmark.cpp -o sort_benchmark
+//   ./sort_benchmark --pattern all --size 1000000 --seed 1
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <utility>
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include <chrono>
+#include <random>
+#include <cstring>
+#include <cstddef>
+#include <limits>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
+
+#include "BenchmarkSupport.h"
+#include "../../array_sort/common/src/WorkStealingPool.h"
+#include "../../array_sort/sort_network/src/SortingNetwork.h"
+#include "../../array_sort/sort_merge/src/AdaptiveMergeSort.h"
+#include "../../array_sort/sort_radix/src/RadixSort.h"
+
+// 各デモは1つのファイルで完結しているため、名前空間に分けてそのまま取り込みます。
+// 標準ヘッダーとデモが共有するヘッダーは上で先に取り込んでおき、デモの main() は別名にします。
+#define main demo_main
+namespace bubble {
+#include "../../array_sort/sort_bubble/src/BubbleSortDemo.cpp"
+}
+namespace selection {
+#include "../../array_sort/sort_selection/src/SelectionSortDemo.cpp"
+}
+namespace insertion {
+#include "../../array_sort/sort_insertion/src/InsertionSortDemo.cpp"
+}
+namespace merge {
+#include "../../array_sort/sort_merge/src/MergeSortDemo.cpp"
+}
+namespace quick {
+#include "../../array_sort/sort_quick/src/QuickSortDemo.cpp"
+}
+namespace heap {
+#include "../../array_sort/sort_heap/src/HeapSortDemo.cpp"
+}
+namespace radix {
+#include "../../array_sort/sort_radix/src/RadixSortDemo.cpp"
+}
+namespace network {
+#include "../../array_sort/sort_network/src/SortingNetworkDemo.cpp"
+}
+#undef main
+
+// int を昇順に並べる比較ですが std::less ではないため、マージソートとクイックソートの BasicArrayData は
+// 基数ソートに切り替えずに比較によるソートの本体を使います (ソーティングネットワークはそのまま使えます)。
+struct ComparisonLess {
+    bool operator()(int a, int b) const {
+        return a < b;
+    }
+};
+template <>
+struct is_ascending_int_less<ComparisonLess> : std::true_type {};
+
+// 入力の並び方ごとに size 個の整数を生成します。
+std::vector<int> generate_input(const std::string& pattern, int size, std::mt19937_64& rng) {
+    std::vector<int> data(size);
+    if (pattern == "random") {
+        for (int& value : data) {
+            value = static_cast<int>(rng());
+        }
+    } else if (pattern == "sorted") {
+        for (int i = 0; i < size; ++i) {
+            data[i] = i;
+        }
+    } else if (pattern == "reversed") {
+        for (int i = 0; i < size; ++i) {
+            data[i] = size - i;
+        }
+    } else if (pattern == "duplicates") {
+        // 16種類の値だけからなる配列
+        for (int& value : data) {
+            value = static_cast<int>(rng() % 16);
+        }
+    } else if (pattern == "nearly_sorted") {
+        // ソート済みの配列の 1% の要素を、ランダムな位置の要素と入れ替える
+        for (int i = 0; i < size; ++i) {
+            data[i] = i;
+        }
+        for (int i = 0; i < size / 100; ++i) {
+            std::swap(data[rng() % size], data[rng() % size]);
+        }
+    } else if (pattern == "appended") {
+        // 時刻順に追記されるデータ: ソート済みの配列の末尾 1% だけがランダムな値
+        for (int i = 0; i < size; ++i) {
+            data[i] = i;
+        }
+        for (int i = size - size / 100; i < size; ++i) {
+            data[i] = static_cast<int>(rng() % size);
+        }
+    } else {
+        data.clear();
+    }
+    return data;
+}
+
+// 1つのアルゴリズムの計測結果
+struct BenchmarkResult {
+    std::string algorithm;
+    bool skipped;
+    bool sorted;
+    double seconds;
+    unsigned long long allocations;
+    long peak_rss_kb;
+};
+
+// 子プロセスで入力を load(array_data, input) で読み込み (ここは計測しない)、run(array_data) の実行時間・
+// メモリ確保回数と、子プロセスの最大常駐メモリを計測します。
+// 結果が expected (std::sort の結果) と一致するかも確認します (確認にかかる時間は計測しません)。
+template <typename Array, typename Load, typename Run>
+BenchmarkResult measure(const std::string& algorithm, const std::vector<int>& input,
+                        const std::vector<int>& expected, Load load, Run run) {
+    Measurement measurement = measure_in_child([&]() {
+        Array array_data;
+        load(array_data, input);
+
+        Measurement run_measurement = measure_run([&]() {
+            run(array_data);
+            return true;
+        });
+        run_measurement.ok = array_data.get() == expected;
+        return run_measurement;
+    });
+    return BenchmarkResult{algorithm, false, measurement.ok, measurement.seconds, measurement.allocations,
+                           measurement.peak_rss_kb};
+}
+
+template <typename Array, typename Load>
+BenchmarkResult measure(const std::string& algorithm, const std::vector<int>& input,
+                        const std::vector<int>& expected, Load load) {
+    return measure<Array>(algorithm, input, expected, load, [](Array& array_data) {
+        array_data.sort();
+    });
+}
+
+template <typename Array>
+BenchmarkResult measure(const std::string& algorithm, const std::vector<int>& input,
+                        const std::vector<int>& expected) {
+    return measure<Array>(algorithm, input, expected, [](Array& array_data, const std::vector<int>& data) {
+        array_data.set(data);
+    });
+}
+
+// set(data) で読み込み、parallel_sort(num_threads) の実行時間を計測します。
+template <typename Array>
+BenchmarkResult measure_parallel(const std::string& algorithm, const std::vector<int>& input,
+                                 const std::vector<int>& expected, unsigned int num_threads) {
+    return measure<Array>(algorithm, input, expected,
+        [](Array& array_data, const std::vector<int>& data) {
+            array_data.set(data);
+        },
+        [num_threads](Array& array_data) {
+            array_data.parallel_sort(num_threads);
+        });
+}
+
+BenchmarkResult skipped(const std::string& algorithm) {
+    return BenchmarkResult{algorithm, true, false, 0.0, 0, 0};
+}
+
+// 1つの入力に対してすべてのアルゴリズムを計測します。
+// O(n^2) のアルゴリズムは max_quadratic_size を超える入力では計測しません。
+std::vector<BenchmarkResult> run_all(const std::vector<int>& input, int max_quadratic_size, unsigned int num_threads) {
+    std::vector<int> expected = input;
+    std::sort(expected.begin(), expected.end());
+    const bool quadratic_ok = static_cast<int>(input.size()) <= max_quadratic_size;
+    std::vector<BenchmarkResult> results;
+
+    results.push_back(quadratic_ok ? measure<bubble::ArrayData>("bubble", input, expected) : skipped("bubble"));
+    results.push_back(quadratic_ok ? measure<selection::ArrayData>("selection", input, expected) : skipped("selection"));
+    results.push_back(quadratic_ok ? measure<insertion::ArrayData>("insertion", input, expected) : skipped("insertion"));
+    results.push_back(measure<merge::BasicArrayData<int, ComparisonLess>>("merge", input, expected));
+    results.push_back(measure_parallel<merge::BasicArrayData<int, ComparisonLess>>("merge_parallel", input, expected, num_threads));
+    results.push_back(measure<quick::BasicArrayData<int, ComparisonLess>>("quick", input, expected));
+    results.push_back(measure_parallel<quick::BasicArrayData<int, ComparisonLess>>("quick_parallel", input, expected, num_threads));
+    results.push_back(measure<heap::HeapData>("heap", input, expected,
+        [](heap::HeapData& heap_data, const std::vector<int>& data) {
+            heap_data.heapify(data);
+        }));
+    results.push_back(measure<radix::ArrayData>("radix", input, expected));
+    results.push_back(measure<network::ArrayData>("network", input, expected));
+    return results;
+}
+
+// 計測結果を JSON で出力します。
+void print_json(const std::string& pattern, int size, unsigned long long seed,
+                const std::vector<BenchmarkResult>& results, bool last) {
+    std::cout << "  {\"pattern\": \"" << pattern << "\", \"size\": " << size
+              << ", \"seed\": " << seed << ", \"results\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& result = results[i];
+        std::cout << "    {\"algorithm\": \"" << result.algorithm << "\"";
+        if (result.skipped) {
+            std::cout << ", \"skipped\": true";
+        } else {
+            double elements_per_second = result.seconds > 0 ? size / result.seconds : 0.0;
+            std::cout << ", \"skipped\": false, \"sorted\": " << (result.sorted ? "true" : "false")
+                      << ", \"seconds\": " << result.seconds
+                      << ", \"elements_per_second\": " << elements_per_second
+                      << ", \"allocations\": " << result.allocations
+                      << ", \"peak_rss_kb\": " << result.peak_rss_kb;
+        }
+        std::cout << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    std::cout << "  ]}" << (last ? "" : ",") << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string pattern = "all";
+    int size = 1000000;
+    unsigned long long seed = 1;
+    int max_quadratic_size = 20000;
+    unsigned int num_threads = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        std::string value = argv[i + 1];
+        if (option == "--pattern") {
+            pattern = value;
+        } else if (option == "--size") {
+            size = std::stoi(value);
+        } else if (option == "--seed") {
+            seed = std::stoull(value);
+        } else if (option == "--max-quadratic-size") {
+            max_quadratic_size = std::stoi(value);
+        } else if (option == "--threads") {
+            num_threads = static_cast<unsigned int>(std::stoul(value));
+        } else {
+            std::cerr << "ERROR: 不明なオプション " << option << std::endl;
+            return 1;
+        }
+    }
+    if (size < 1) {
+        std::cerr << "ERROR: --size は1以上を指定してください。" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> patterns;
+    if (pattern == "all") {
+        patterns = {"random", "sorted", "reversed", "duplicates", "nearly_sorted", "appended"};
+    } else {
+        patterns = {pattern};
+    }
+
+    std::cout << "[" << std::endl;
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        std::mt19937_64 rng(seed);
+        std::vector<int> input = generate_input(patterns[i], size, rng);
+        if (input.empty()) {
+            std::cerr << "ERROR: 不明な入力の並び " << patterns[i] << std::endl;
+            return 1;
+        }
+        print_json(patterns[i], size, seed, run_all(input, max_quadratic_size, num_threads),
+                   i + 1 == patterns.size());
+    }
+    std::cout << "]" << std::endl;
+    return 0;
+}
@@ -8,6 +8,203 @@
 #include <queue>
 #include <algorithm>
 #include <tuple>
+#include <string>
+#include <thread>
+#include <atomic>
+
+#include "../../common/src/CsrTraversal.h"
+
+// 重みを Weight 型に変換した CSR を作ります。頂点IDと names/index はそのまま引き継ぎます。
+// Weight で表せない重み (範囲外や符号が変わるもの) があれば false を返し、converted は変更しません。
+template <typename Weight, typename Source>
+bool convert_csr_weights(const BasicCsrGraph<Source>& csr, BasicCsrGraph<Weight>& converted) {
+    std::vector<Weight> weights;
+    weights.reserve(csr.weights.size());
+    for (Source weight : csr.weights) {
+        Weight value = static_cast<Weight>(weight);
+        if (static_cast<Source>(value) != weight || (value < Weight()) != (weight < Source())) {
+            return false;
+        }
+        weights.push_back(value);
+    }
+    converted.names = csr.names;
+    converted.index = csr.index;
+    converted.offsets = csr.offsets;
+    converted.targets = csr.targets;
+    converted.weights = std::move(weights);
+    return true;
+}
+
+// CSR を作るときの頂点IDの振り方です。
+// 探索で続けて訪れる頂点に近いIDを振ると、訪問済みの印や隣接辺の配列へのアクセスが局所化されます。
+enum class VertexOrder {
+    Name,       // 頂点名の順 (既定)
+    Bfs,        // 幅優先探索で訪れた順
+    Rcm,        // 逆 Cuthill-McKee 順 (隣接行列の帯幅を小さくする)
+    Degree      // 次数の大きい順
+};
+
+// 頂点の並べ方 order に従って、新しいID -> 元のID の対応表を作ります。
+template <typename Weight>
+std::vector<int> compute_vertex_order(const BasicCsrGraph<Weight>& csr, VertexOrder order) {
+    const int num_vertices = csr.num_vertices();
+    std::vector<int> new_to_old(num_vertices);
+    for (int v = 0; v < num_vertices; ++v) {
+        new_to_old[v] = v;
+    }
+    auto degree = [&csr](int v) {
+        return csr.offsets[v + 1] - csr.offsets[v];
+    };
+
+    if (order == VertexOrder::Degree) {
+        std::stable_sort(new_to_old.begin(), new_to_old.end(), [&degree](int a, int b) {
+            return degree(a) > degree(b);
+        });
+    } else if (order == VertexOrder::Bfs || order == VertexOrder::Rcm) {
+        // RCM では各連結成分を次数が最小の頂点から始め、隣接頂点を次数の小さい順に訪れる
+        std::vector<int> roots = new_to_old;
+        if (order == VertexOrder::Rcm) {
+            std::stable_sort(roots.begin(), roots.end(), [&degree](int a, int b) {
+                return degree(a) < degree(b);
+            });
+        }
+        std::vector<char> visited(num_vertices, 0);
+        std::vector<int> neighbors;
+        size_t head = 0;
+        size_t tail = 0;
+        for (int root : roots) {
+            if (visited[root]) {
+                continue;
+            }
+            visited[root] = 1;
+            new_to_old[tail++] = root;
+            while (head < tail) {
+                int u = new_to_old[head++];
+                neighbors.clear();
+                for (int e = csr.offsets[u]; e < csr.offsets[u + 1]; ++e) {
+                    if (!visited[csr.targets[e]]) {
+                        visited[csr.targets[e]] = 1;
+                        neighbors.push_back(csr.targets[e]);
+                    }
+                }
+                if (order == VertexOrder::Rcm) {
+                    std::stable_sort(neighbors.begin(), neighbors.end(), [&degree](int a, int b) {
+                        return degree(a) < degree(b);
+                    });
+                }
+                for (int v : neighbors) {
+                    new_to_old[tail++] = v;
+                }
+            }
+        }
+        if (order == VertexOrder::Rcm) {
+            std::reverse(new_to_old.begin(), new_to_old.end());
+        }
+    }
+    return new_to_old;
+}
+
+// 頂点のIDを振り直した CSR を作ります。
+// 各頂点の隣接辺は新しいIDの昇順に並べ替え、names/index は元の頂点名との対応を保ちます。
+template <typename Weight>
+BasicCsrGraph<Weight> reorder_csr(const BasicCsrGraph<Weight>& csr, VertexOrder order) {
+    if (order == VertexOrder::Name) {
+        return csr;
+    }
+    const int num_vertices = csr.num_vertices();
+    std::vector<int> new_to_old = compute_vertex_order(csr, order);
+    std::vector<int> old_to_new(num_vertices);
+    for (int v = 0; v < num_vertices; ++v) {
+        old_to_new[new_to_old[v]] = v;
+    }
+
+    BasicCsrGraph<Weight> reordered;
+    reordered.names.reserve(num_vertices);
+    reordered.offsets.reserve(num_vertices + 1);
+    reordered.targets.reserve(csr.targets.size());
+    reordered.weights.reserve(csr.weights.size());
+    reordered.offsets.push_back(0);
+    std::vector<std::pair<int, Weight>> edges;
+    for (int v = 0; v < num_vertices; ++v) {
+        int old_vertex = new_to_old[v];
+        reordered.index[csr.names[old_vertex]] = v;
+        reordered.names.push_back(csr.names[old_vertex]);
+
+        edges.clear();
+        for (int e = csr.offsets[old_vertex]; e < csr.offsets[old_vertex + 1]; ++e) {
+            edges.push_back(std::make_pair(old_to_new[csr.targets[e]], csr.weights[e]));
+        }
+        std::stable_sort(edges.begin(), edges.end(), [](const std::pair<int, Weight>& a, const std::pair<int, Weight>& b) {
+            return a.first < b.first;
+        });
+        for (const auto& edge : edges) {
+            reordered.targets.push_back(edge.first);
+            reordered.weights.push_back(edge.second);
+        }
+        reordered.offsets.push_back(static_cast<int>(reordered.targets.size()));
+    }
+    return reordered;
+}
+
+// CSR 形式のグラフ (BasicCsrGraph または CompressedCsrGraph) の連結成分をBFSで求め、
+// 各頂点の連結成分番号 (0 から順に振る) を返します。
+template <typename Graph>
+std::vector<int> csr_connected_components(const Graph& csr) {
+    const int num_vertices = csr.num_vertices();
+    std::vector<int> component(num_vertices, -1);
+    std::vector<int> queue(num_vertices);
+    int num_components = 0;
+    for (int root = 0; root < num_vertices; ++root) {
+        if (component[root] != -1) {
+            continue;
+        }
+        size_t head = 0;
+        size_t tail = 0;
+        queue[tail++] = root;
+        component[root] = num_components;
+        while (head < tail) {
+            int u = queue[head++];
+            csr.for_each_edge(u, [&](int v, auto) {
+                if (component[v] == -1) {
+                    component[v] = num_components;
+                    queue[tail++] = v;
+                }
+            });
+        }
+        ++num_components;
+    }
+    return component;
+}
+
+// CSR 形式のグラフ (BasicCsrGraph または CompressedCsrGraph) で、始点から max_hops 本以内の辺でたどれる頂点を
+// (頂点ID, ホップ数) として found に追加します。
+// ホップ数が max_hops に達した頂点の隣接辺はたどらないため、手間は見つけた頂点とその隣接辺の数だけで決まります。
+template <typename Graph>
+void csr_neighborhood(
+    const Graph& csr,
+    int source,
+    int max_hops,
+    TraversalWorkspace& workspace,
+    std::vector<std::pair<int, int>>& found
+) {
+    struct HopLimiter : TraversalVisitor {
+        int max_hops;
+        std::vector<std::pair<int, int>>& found;
+
+        HopLimiter(int hops, std::vector<std::pair<int, int>>& output) : max_hops(hops), found(output) {}
+
+        TraversalControl discover_vertex(int vertex, int depth) {
+            found.push_back(std::make_pair(vertex, depth));
+            return depth < max_hops ? TraversalControl::Continue : TraversalControl::Skip;
+        }
+    };
+    if (max_hops < 0) {
+        return;
+    }
+    HopLimiter limiter(max_hops, found);
+    workspace.sources.assign(1, source);
+    traverse_csr(csr, workspace.sources, TraversalOrder::Breadth, limiter, workspace);
+}
 
 class GraphData {
 private:
@@ -15,6 +212,29 @@ private:
     // キーは頂点、値は<隣接頂点, 重み>のペアのベクター
     std::unordered_map<std::string, std::vector<std::pair<std::string, int>>> _data;
 
+    // 近傍の探索で使う CSR 形式の隣接表現 (グラフの変更で作り直します)
+    CsrGraph _csr_cache;
+    bool _csr_dirty = true;
+
+    // names の順に振ったIDの CSR を作り、order に従って振り直します。
+    CsrGraph _build_csr(const std::vector<std::string>& names, VertexOrder order) const {
+        CsrGraph csr;
+        csr.names = names;
+        for (size_t i = 0; i < csr.names.size(); ++i) {
+            csr.index[csr.names[i]] = static_cast<int>(i);
+        }
+        csr.offsets.reserve(csr.names.size() + 1);
+        csr.offsets.push_back(0);
+        for (const std::string& vertex : csr.names) {
+            for (const auto& neighbor_pair : _data.at(vertex)) {
+                csr.targets.push_back(csr.index[neighbor_pair.first]);
+                csr.weights.push_back(neighbor_pair.second);
+            }
+            csr.offsets.push_back(static_cast<int>(csr.targets.size()));
+        }
+        return reorder_csr(csr, order);
+    }
+
 public:
     // グラフの内部データを取得
     const std::unordered_map<std::string, std::vector<std::pair<std::string, int>>>& get() const {
@@ -45,6 +265,7 @@ public:
     bool add_vertex(const std::string& vertex) {
         if (_data.find(vertex) == _data.end()) {
             _data[vertex] = std::vector<std::pair<std::string, int>>();
+            _csr_dirty = true;
         }
         return true;
     }
@@ -54,6 +275,7 @@ public:
         // 頂点を追加（存在しない場合）
         add_vertex(vertex1);
         add_vertex(vertex2);
+        _csr_dirty = true;
 
         // vertex1 -> vertex2 の辺を追加
         bool edge_exists_v1v2 = false;
@@ -87,53 +309,129 @@ public:
     // グラフを空にする
     bool clear() {
         _data.clear();
+        _csr_cache = CsrGraph();
+        _csr_dirty = true;
         return true;
     }
 
     // グラフの連結成分をBFSを使用して見つける
-    std::vector<std::vector<std::string>> get_connected_components() {
-        std::unordered_set<std::string> visited;
-        std::vector<std::vector<std::string>> all_components;
+    // (頂点を get_vertices の順に、隣接頂点を辺を追加した順にたどります)
+    std::vector<std::vector<std::string>> get_connected_components() const {
+        CsrGraph csr = _build_csr(get_vertices(), VertexOrder::Name);
+        std::vector<int> sources(csr.num_vertices());
+        for (int v = 0; v < csr.num_vertices(); ++v) {
+            sources[v] = v;
+        }
+        ComponentCollector collector(csr);
+        TraversalWorkspace workspace;
+        traverse_csr(csr, sources, TraversalOrder::Breadth, collector, workspace);
+        return collector.components;
+    }
 
-        // グラフのすべての頂点を取得
-        std::vector<std::string> vertices = get_vertices();
-
-        // すべての頂点を順番にチェック
-        for (const std::string& vertex : vertices) {
-            // もしその頂点がまだ訪問されていなければ、新しい連結成分の開始点
-            if (visited.find(vertex) == visited.end()) {
-                std::vector<std::string> current_component;
-                std::queue<std::string> queue;
-                queue.push(vertex);
-                visited.insert(vertex);
-                current_component.push_back(vertex);
-
-                // BFSを開始
-                while (!queue.empty()) {
-                    std::string u = queue.front();
-                    queue.pop();
-
-                    // 取り出した頂点の隣接リストを取得
-                    const auto* neighbors_with_weight = get_neighbors(u);
-
-                    // 頂点が存在し、隣接ノードがある場合
-                    if (neighbors_with_weight != nullptr) {
-                        for (const auto& neighbor_pair : *neighbors_with_weight) {
-                            // 隣接する頂点がまだ訪問されていなければ
-                            if (visited.find(neighbor_pair.first) == visited.end()) {
-                                visited.insert(neighbor_pair.first);
-                                queue.push(neighbor_pair.first);
-                                current_component.push_back(neighbor_pair.first);
-                            }
-                        }
-                    }
-                }
+    // 頂点名の順にIDを振った CSR 形式の隣接表現を返します。
+    // グラフが変更されていなければ前回作成したものを再利用します。
+    const CsrGraph& get_csr() {
+        if (_csr_dirty) {
+            _csr_cache = build_csr();
+            _csr_dirty = false;
+        }
+        return _csr_cache;
+    }
+
+    // 始点から max_hops 本以内の辺でたどれる頂点とその辺の数 (ホップ数) を、幅優先で見つけた順に返します。
+    // 始点自身 (ホップ数0) を含みます。
+    std::vector<std::pair<std::string, int>> get_neighborhood(const std::string& start_vertex, int max_hops) {
+        std::vector<std::pair<std::string, int>> vertices;
+        const CsrGraph& csr = get_csr();
+        auto it = csr.index.find(start_vertex);
+        if (it == csr.index.end()) {
+            std::cout << "ERROR: 開始頂点 '" << start_vertex << "' がグラフに存在しません。" << std::endl;
+            return vertices;
+        }
+        static thread_local TraversalWorkspace workspace;
+        static thread_local std::vector<std::pair<int, int>> found;
+        found.clear();
+        csr_neighborhood(csr, it->second, max_hops, workspace, found);
+        vertices.reserve(found.size());
+        for (const auto& vertex_hops : found) {
+            vertices.push_back(std::make_pair(csr.names[vertex_hops.first], vertex_hops.second));
+        }
+        return vertices;
+    }
+
+    // 複数の始点について、始点ごとの get_neighborhood をまとめて計算します。
+    // 始点は num_threads 個のスレッドに分配されます (0 の場合はハードウェアの並列数)。
+    // 結果は sources と同じ順に並び、グラフに存在しない始点の結果は空になります。
+    std::vector<std::vector<std::pair<std::string, int>>> get_neighborhood(
+        const std::vector<std::string>& sources,
+        int max_hops,
+        unsigned int num_threads = 0
+    ) {
+        std::vector<std::vector<std::pair<std::string, int>>> results(sources.size());
+        if (sources.empty()) {
+            return results;
+        }
+        const CsrGraph& csr = get_csr();
+
+        if (num_threads == 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        num_threads = static_cast<unsigned int>(std::min<size_t>(num_threads, sources.size()));
 
-                // BFSが終了したら、1つの連結成分が見つかった
-                all_components.push_back(current_component);
+        // 各スレッドは次に処理する始点の番号を共有カウンタから取り出す
+        std::atomic<size_t> next_source(0);
+        auto worker = [&]() {
+            TraversalWorkspace workspace;
+            std::vector<std::pair<int, int>> found;
+            for (size_t i = next_source++; i < sources.size(); i = next_source++) {
+                auto it = csr.index.find(sources[i]);
+                if (it == csr.index.end()) {
+                    continue;
+                }
+                found.clear();
+                csr_neighborhood(csr, it->second, max_hops, workspace, found);
+                results[i].reserve(found.size());
+                for (const auto& vertex_hops : found) {
+                    results[i].push_back(std::make_pair(csr.names[vertex_hops.first], vertex_hops.second));
+                }
             }
+        };
+        std::vector<std::thread> threads;
+        for (unsigned int t = 1; t < num_threads; ++t) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
         }
+        return results;
+    }
+
+    // 隣接リストを整数IDの CSR 形式に変換します。
+    // 頂点IDは order に従って振ります (VertexOrder::Name では頂点名の順)。
+    CsrGraph build_csr(VertexOrder order = VertexOrder::Name) const {
+        std::vector<std::string> names = get_vertices();
+        std::sort(names.begin(), names.end());
+        return _build_csr(names, order);
+    }
 
+    // 隣接リストを圧縮した CSR 形式に変換します (頂点IDの振り方は build_csr と同じです)。
+    CompressedCsrGraph build_compressed_csr(VertexOrder order = VertexOrder::Name) const {
+        return compress_csr(build_csr(order));
+    }
+
+    // CSR 形式に変換したグラフの連結成分をBFSで見つけます。
+    // 連結成分とその中の頂点は、order で振った頂点IDの順に並びます。
+    std::vector<std::vector<std::string>> get_connected_components(VertexOrder order) const {
+        CsrGraph csr = build_csr(order);
+        std::vector<int> component = csr_connected_components(csr);
+        std::vector<std::vector<std::string>> all_components;
+        for (int v = 0; v < csr.num_vertices(); ++v) {
+            if (component[v] == static_cast<int>(all_components.size())) {
+                all_components.emplace_back();
+            }
+            all_components[component[v]].push_back(csr.names[v]);
+        }
         return all_components;
     }
 };
@@ -230,6 +528,89 @@ int main() {
     print_connected_components(output);
     std::cout << std::endl;
 
+    std::cout << "\nget_connected_components (CSR)" << std::endl;
+    graph_data.clear();
+    inputList = {{"A", "D", 1}, {"D", "B", 1}, {"B", "E", 1}, {"C", "F", 1}, {"F", "G", 1}};
+    for (const auto& input : inputList) {
+        graph_data.add_edge(std::get<0>(input), std::get<1>(input), std::get<2>(input));
+    }
+    const std::vector<std::pair<VertexOrder, std::string>> orders = {
+        {VertexOrder::Name, "頂点名順"}, {VertexOrder::Bfs, "幅優先順"},
+        {VertexOrder::Rcm, "RCM順"}, {VertexOrder::Degree, "次数順"}
+    };
+    for (const auto& order : orders) {
+        std::cout << "  " << order.second << " のID: ";
+        print_vector(graph_data.build_csr(order.first).names);
+        std::cout << ", 連結成分: ";
+        print_connected_components(graph_data.get_connected_components(order.first));
+        std::cout << std::endl;
+    }
+    CsrGraph csr = graph_data.build_csr(VertexOrder::Bfs);
+    CompressedCsrGraph compressed = graph_data.build_compressed_csr(VertexOrder::Bfs);
+    std::cout << "  圧縮した隣接表現の連結成分番号は" << (csr_connected_components(compressed) == csr_connected_components(csr) ? "一致します" : "一致しません")
+              << " (隣接表現のメモリ: " << csr.memory_bytes() << " バイト -> " << compressed.memory_bytes() << " バイト)" << std::endl;
+    BasicCsrGraph<unsigned short> compact;
+    if (convert_csr_weights(csr, compact)) {
+        std::cout << "  unsigned short の重みの隣接表現の連結成分番号は" << (csr_connected_components(compact) == csr_connected_components(csr) ? "一致します" : "一致しません")
+                  << " (隣接表現のメモリ: " << csr.memory_bytes() << " バイト -> " << compact.memory_bytes() << " バイト)" << std::endl;
+    }
+
+    std::cout << "\ntraverse_csr" << std::endl;
+    // 目的の頂点を見つけた時点で探索を終了する訪問者
+    struct FindVertex : TraversalVisitor {
+        int target = -1;
+        int discovered = 0;
+        TraversalControl discover_vertex(int vertex, int) {
+            ++discovered;
+            return vertex == target ? TraversalControl::Stop : TraversalControl::Continue;
+        }
+    };
+    // 帰りがけ順に頂点を記録する訪問者
+    struct PostOrder : TraversalVisitor {
+        const std::vector<std::string>* names = nullptr;
+        std::vector<std::string> order;
+        TraversalControl finish_vertex(int vertex) {
+            order.push_back((*names)[vertex]);
+            return TraversalControl::Continue;
+        }
+    };
+    csr = graph_data.build_csr();
+    TraversalWorkspace workspace;
+    FindVertex find_vertex;
+    find_vertex.target = csr.index.at("E");
+    bool completed = traverse_csr(csr, {csr.index.at("A")}, TraversalOrder::Breadth, find_vertex, workspace);
+    std::cout << "  A から E に到達" << (completed ? "できません" : "できます")
+              << " (見つけた頂点の数: " << find_vertex.discovered << ")" << std::endl;
+    PostOrder post_order;
+    post_order.names = &csr.names;
+    traverse_csr(csr, {csr.index.at("A"), csr.index.at("C")}, TraversalOrder::Depth, post_order, workspace);
+    std::cout << "  深さ優先の帰りがけ順: ";
+    print_vector(post_order.order);
+    std::cout << std::endl;
+    // 圧縮した隣接表現も同じ訪問者で探索できる (隣接頂点はIDの昇順にたどる)
+    compressed = graph_data.build_compressed_csr();
+    PostOrder compressed_post_order;
+    compressed_post_order.names = &compressed.names;
+    traverse_csr(compressed, {compressed.index.at("A"), compressed.index.at("C")}, TraversalOrder::Depth,
+                 compressed_post_order, workspace);
+    std::cout << "  圧縮した隣接表現での深さ優先の帰りがけ順: ";
+    print_vector(compressed_post_order.order);
+    std::cout << std::endl;
+
+    std::cout << "\nget_neighborhood" << std::endl;
+    auto neighborhood = graph_data.get_neighborhood("A", 2);
+    std::cout << "  A から2ホップ以内の頂点: ";
+    for (const auto& vertex_hops : neighborhood) {
+        std::cout << vertex_hops.first << "(" << vertex_hops.second << ") ";
+    }
+    std::cout << std::endl;
+    auto neighborhoods = graph_data.get_neighborhood(std::vector<std::string>{"A", "C", "Z"}, 1);
+    std::cout << "  1ホップ以内の頂点の数 (A, C, Z): ";
+    for (const auto& vertices : neighborhoods) {
+        std::cout << vertices.size() << " ";
+    }
+    std::cout << std::endl;
+
     std::cout << "Bfs TEST <----- end" << std::endl;
 
     return 0;
@@ -0,0 +1,393 @@
+// C++
+// グラフの連結成分の共通部品: CSR 形式の隣接表現と、訪問者による幅優先・深さ優先探索
+//
+// BFS と DFS のデモ、およびグラフのベンチマークで共有します。
+
+#ifndef CSR_TRAVERSAL_H
+#define CSR_TRAVERSAL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 隣接辺を1本ずつ取り出すためのカーソルです。
+// 深さ優先探索で、頂点ごとに調べかけの隣接辺の位置を覚えておくのに使います。
+struct EdgeCursor {
+    size_t position;          // 次に読む位置 (BasicCsrGraph では辺の番号、CompressedCsrGraph ではバイト位置)
+    unsigned int remaining;   // 残りの辺の数
+    int target;               // 直前に取り出した隣接頂点ID (CompressedCsrGraph で差分の基準にします)
+};
+
+// 頂点名を整数IDに置き換えた CSR (Compressed Sparse Row) 形式の隣接表現です。
+// 頂点 v の隣接辺は targets/weights の [offsets[v], offsets[v + 1]) に連続して並びます。
+// 重みの型は Weight で、例えば BasicCsrGraph<unsigned short> は重みの配列が int の半分になります。
+template <typename Weight>
+struct BasicCsrGraph {
+    std::vector<std::string> names;              // ID -> 頂点名
+    std::unordered_map<std::string, int> index;  // 頂点名 -> ID
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<Weight> weights;
+
+    int num_vertices() const {
+        return static_cast<int>(names.size());
+    }
+
+    int degree(int vertex) const {
+        return offsets[vertex + 1] - offsets[vertex];
+    }
+
+    // 頂点 vertex の隣接辺ごとに visit(隣接頂点ID, 重み) を呼び出します。
+    template <typename Visitor>
+    void for_each_edge(int vertex, Visitor visit) const {
+        for (int e = offsets[vertex]; e < offsets[vertex + 1]; ++e) {
+            visit(targets[e], weights[e]);
+        }
+    }
+
+    // 頂点 vertex の隣接辺を先頭から取り出すカーソルを返します。
+    EdgeCursor edge_cursor(int vertex) const {
+        return EdgeCursor{static_cast<size_t>(offsets[vertex]), static_cast<unsigned int>(degree(vertex)), 0};
+    }
+
+    // cursor の次の隣接辺について visit(隣接頂点ID, 重み) を呼び出し、カーソルを進めます。
+    // 隣接辺が残っていなければ何もせずに false を返します。
+    template <typename Visitor>
+    bool next_edge(EdgeCursor& cursor, Visitor visit) const {
+        if (cursor.remaining == 0) {
+            return false;
+        }
+        --cursor.remaining;
+        size_t e = cursor.position++;
+        visit(targets[e], weights[e]);
+        return true;
+    }
+
+    // 隣接表現 (頂点名を除く) が使うメモリのバイト数
+    size_t memory_bytes() const {
+        return (offsets.capacity() + targets.capacity()) * sizeof(int) + weights.capacity() * sizeof(Weight);
+    }
+};
+
+typedef BasicCsrGraph<int> CsrGraph;
+
+// 符号なし整数を可変長 (1バイトあたり7ビット、最上位ビットが継続の印) で末尾に追加します。
+inline void encode_varint(std::vector<unsigned char>& bytes, unsigned int value) {
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<unsigned char>(value));
+}
+
+// position から可変長の整数を1つ読み、position を次の整数の先頭に進めます。
+inline unsigned int decode_varint(const unsigned char*& position) {
+    unsigned int value = *position & 0x7f;
+    int shift = 7;
+    while (*position++ & 0x80) {
+        value |= static_cast<unsigned int>(*position & 0x7f) << shift;
+        shift += 7;
+    }
+    return value;
+}
+
+// 負の重みも短く符号化できるように、0, -1, 1, -2, ... を 0, 1, 2, 3, ... に対応させます。
+inline unsigned int zigzag_encode(int value) {
+    return (static_cast<unsigned int>(value) << 1) ^ static_cast<unsigned int>(value >> 31);
+}
+
+inline int zigzag_decode(unsigned int value) {
+    return static_cast<int>(value >> 1) ^ -static_cast<int>(value & 1);
+}
+
+// 隣接リストを圧縮して保持する CSR 形式の隣接表現です。CsrGraph と同じ方法で探索できます。
+// 頂点ごとに次数、続いて (隣接頂点IDの前の辺との差, 重み) の組を可変長整数で並べます。
+// 隣接頂点IDは昇順に並べ替えてあるため差は小さく、多くの辺は2〜3バイトに収まります。
+// 隣接辺は for_each_edge や next_edge の中で先頭から順に復号します。
+struct CompressedCsrGraph {
+    std::vector<std::string> names;              // ID -> 頂点名
+    std::unordered_map<std::string, int> index;  // 頂点名 -> ID
+    std::vector<size_t> offsets;                 // 頂点ごとの bytes の開始位置
+    std::vector<unsigned char> bytes;
+
+    int num_vertices() const {
+        return static_cast<int>(names.size());
+    }
+
+    int degree(int vertex) const {
+        const unsigned char* position = bytes.data() + offsets[vertex];
+        return static_cast<int>(decode_varint(position));
+    }
+
+    // 頂点 vertex の隣接辺ごとに visit(隣接頂点ID, 重み) を呼び出します。
+    template <typename Visitor>
+    void for_each_edge(int vertex, Visitor visit) const {
+        const unsigned char* position = bytes.data() + offsets[vertex];
+        unsigned int remaining = decode_varint(position);
+        int target = 0;
+        while (remaining-- > 0) {
+            target += static_cast<int>(decode_varint(position));
+            visit(target, zigzag_decode(decode_varint(position)));
+        }
+    }
+
+    // 頂点 vertex の隣接辺を先頭から取り出すカーソルを返します (次数を読み飛ばした位置から始めます)。
+    EdgeCursor edge_cursor(int vertex) const {
+        const unsigned char* position = bytes.data() + offsets[vertex];
+        unsigned int remaining = decode_varint(position);
+        return EdgeCursor{static_cast<size_t>(position - bytes.data()), remaining, 0};
+    }
+
+    // cursor の次の隣接辺について visit(隣接頂点ID, 重み) を呼び出し、カーソルを進めます。
+    // 隣接辺が残っていなければ何もせずに false を返します。
+    template <typename Visitor>
+    bool next_edge(EdgeCursor& cursor, Visitor visit) const {
+        if (cursor.remaining == 0) {
+            return false;
+        }
+        --cursor.remaining;
+        const unsigned char* position = bytes.data() + cursor.position;
+        cursor.target += static_cast<int>(decode_varint(position));
+        int weight = zigzag_decode(decode_varint(position));
+        cursor.position = position - bytes.data();
+        visit(cursor.target, weight);
+        return true;
+    }
+
+    // 隣接表現 (頂点名を除く) が使うメモリのバイト数
+    size_t memory_bytes() const {
+        return offsets.capacity() * sizeof(size_t) + bytes.capacity();
+    }
+};
+
+// CSR 形式のグラフを圧縮します。頂点IDと names/index はそのまま引き継ぎます。
+inline CompressedCsrGraph compress_csr(const CsrGraph& csr) {
+    const int num_vertices = csr.num_vertices();
+    CompressedCsrGraph compressed;
+    compressed.names = csr.names;
+    compressed.index = csr.index;
+    compressed.offsets.reserve(num_vertices + 1);
+    std::vector<std::pair<int, int>> edges;
+    for (int v = 0; v < num_vertices; ++v) {
+        compressed.offsets.push_back(compressed.bytes.size());
+        edges.clear();
+        csr.for_each_edge(v, [&edges](int target, int weight) {
+            edges.push_back(std::make_pair(target, weight));
+        });
+        std::stable_sort(edges.begin(), edges.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+            return a.first < b.first;
+        });
+        encode_varint(compressed.bytes, static_cast<unsigned int>(edges.size()));
+        int previous = 0;
+        for (const auto& edge : edges) {
+            encode_varint(compressed.bytes, static_cast<unsigned int>(edge.first - previous));
+            encode_varint(compressed.bytes, zigzag_encode(edge.second));
+            previous = edge.first;
+        }
+    }
+    compressed.offsets.push_back(compressed.bytes.size());
+    compressed.bytes.shrink_to_fit();
+    return compressed;
+}
+
+// 訪問者の各関数が返す値です。
+enum class TraversalControl {
+    Continue,   // そのまま探索を続ける
+    Skip,       // この頂点の隣接辺 (examine_edge ではこの辺) をたどらない
+    Stop        // 探索全体を終了する
+};
+
+// 探索の順序です。
+enum class TraversalOrder {
+    Breadth,    // 幅優先
+    Depth       // 深さ優先
+};
+
+// 何もしない訪問者です。必要な関数だけを派生クラスで同じ名前で定義します。
+// discover_vertex(v, 深さ): 頂点を初めて見つけたとき (深さは探索の始点からの辺の数)
+// examine_edge(u, v, 重み): 頂点 u の隣接辺を調べるとき (v が訪問済みかどうかに関わらず)
+// finish_vertex(v): 頂点の隣接辺をすべて調べ終えたとき (深さ優先では帰りがけ順)
+struct TraversalVisitor {
+    TraversalControl discover_vertex(int, int) {
+        return TraversalControl::Continue;
+    }
+    template <typename Weight>
+    TraversalControl examine_edge(int, int, Weight) {
+        return TraversalControl::Continue;
+    }
+    TraversalControl finish_vertex(int) {
+        return TraversalControl::Continue;
+    }
+};
+
+// 探索ごとに使い回す作業領域です。
+// 訪問済みの印と深さは版番号 (stamp) 付きで保持するため、reset は版番号を進めるだけの O(1) で済み、
+// 探索の手間は訪れた頂点と辺の数だけで決まります。
+// 1つの作業領域を複数のスレッドで同時に使うことはできません (スレッドごとに用意します)。
+class TraversalWorkspace {
+private:
+    std::vector<unsigned int> _stamps;
+    std::vector<int> _depths;
+    unsigned int _current_stamp = 0;
+
+public:
+    std::vector<int> queue;                         // 幅優先のキュー
+    std::vector<std::pair<int, EdgeCursor>> stack;  // 深さ優先のスタック (頂点, 次に調べる辺のカーソル)
+    std::vector<int> sources;                       // 始点の一覧 (探索ごとに確保し直さないよう使い回す。reset では消去しない)
+
+    // 頂点数 num_vertices のグラフに対する新しい探索を始めます。
+    void reset(int num_vertices) {
+        if (_stamps.size() < static_cast<size_t>(num_vertices)) {
+            _stamps.resize(num_vertices, 0);
+            _depths.resize(num_vertices);
+        }
+        // 版番号が一周した場合だけ全体を消去する
+        if (++_current_stamp == 0) {
+            std::fill(_stamps.begin(), _stamps.end(), 0);
+            _current_stamp = 1;
+        }
+        queue.clear();
+        stack.clear();
+    }
+
+    bool is_discovered(int vertex) const {
+        return _stamps[vertex] == _current_stamp;
+    }
+
+    int depth(int vertex) const {
+        return is_discovered(vertex) ? _depths[vertex] : -1;
+    }
+
+    void discover(int vertex, int depth) {
+        _stamps[vertex] = _current_stamp;
+        _depths[vertex] = depth;
+    }
+};
+
+// CSR 形式のグラフ (BasicCsrGraph または CompressedCsrGraph) を sources の各頂点から順に探索し、
+// 訪問者の関数を呼び出します。
+// すでに訪れた始点は読み飛ばすため、全頂点を sources に渡すと連結成分ごとの探索になります。
+// 隣接辺は edge_cursor/next_edge で取り出し、examine_edge にはグラフの重みの型のまま重みを渡します。
+// 訪問者が Stop を返して途中で終了した場合は false を返します。
+template <typename Graph, typename Visitor>
+bool traverse_csr(
+    const Graph& csr,
+    const std::vector<int>& sources,
+    TraversalOrder order,
+    Visitor& visitor,
+    TraversalWorkspace& workspace
+) {
+    workspace.reset(csr.num_vertices());
+    for (int source : sources) {
+        if (workspace.is_discovered(source)) {
+            continue;
+        }
+        workspace.discover(source, 0);
+        TraversalControl control = visitor.discover_vertex(source, 0);
+        if (control == TraversalControl::Stop) {
+            return false;
+        }
+        if (control == TraversalControl::Skip) {
+            if (visitor.finish_vertex(source) == TraversalControl::Stop) {
+                return false;
+            }
+            continue;
+        }
+
+        if (order == TraversalOrder::Breadth) {
+            std::vector<int>& queue = workspace.queue;
+            queue.clear();
+            queue.push_back(source);
+            for (size_t head = 0; head < queue.size(); ++head) {
+                int u = queue[head];
+                int next_depth = workspace.depth(u) + 1;
+                EdgeCursor cursor = csr.edge_cursor(u);
+                int v = 0;
+                while (csr.next_edge(cursor, [&](int target, auto weight) {
+                    v = target;
+                    control = visitor.examine_edge(u, target, weight);
+                })) {
+                    if (control == TraversalControl::Stop) {
+                        return false;
+                    }
+                    if (control == TraversalControl::Skip || workspace.is_discovered(v)) {
+                        continue;
+                    }
+                    workspace.discover(v, next_depth);
+                    control = visitor.discover_vertex(v, next_depth);
+                    if (control == TraversalControl::Stop) {
+                        return false;
+                    }
+                    if (control == TraversalControl::Continue) {
+                        queue.push_back(v);
+                    } else if (visitor.finish_vertex(v) == TraversalControl::Stop) {
+                        return false;
+                    }
+                }
+                if (visitor.finish_vertex(u) == TraversalControl::Stop) {
+                    return false;
+                }
+            }
+        } else {
+            // 再帰を使わず、頂点ごとに調べかけの隣接辺のカーソルをスタックに積む
+            std::vector<std::pair<int, EdgeCursor>>& stack = workspace.stack;
+            stack.clear();
+            stack.push_back(std::make_pair(source, csr.edge_cursor(source)));
+            while (!stack.empty()) {
+                int u = stack.back().first;
+                int v = 0;
+                if (!csr.next_edge(stack.back().second, [&](int target, auto weight) {
+                    v = target;
+                    control = visitor.examine_edge(u, target, weight);
+                })) {
+                    stack.pop_back();
+                    if (visitor.finish_vertex(u) == TraversalControl::Stop) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (control == TraversalControl::Stop) {
+                    return false;
+                }
+                if (control == TraversalControl::Skip || workspace.is_discovered(v)) {
+                    continue;
+                }
+                int depth = static_cast<int>(stack.size());
+                workspace.discover(v, depth);
+                control = visitor.discover_vertex(v, depth);
+                if (control == TraversalControl::Stop) {
+                    return false;
+                }
+                if (control == TraversalControl::Continue) {
+                    stack.push_back(std::make_pair(v, csr.edge_cursor(v)));
+                } else if (visitor.finish_vertex(v) == TraversalControl::Stop) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// 探索で見つけた頂点を連結成分ごとにまとめる訪問者です (始点からの深さが0なら新しい連結成分)。
+struct ComponentCollector : TraversalVisitor {
+    const std::vector<std::string>& names;
+    std::vector<std::vector<std::string>> components;
+
+    // graph は BasicCsrGraph か CompressedCsrGraph で、頂点名は graph.names から引きます。
+    template <typename Graph>
+    explicit ComponentCollector(const Graph& graph) : names(graph.names) {}
+
+    TraversalControl discover_vertex(int vertex, int depth) {
+        if (depth == 0) {
+            components.emplace_back();
+        }
+        components.back().push_back(names[vertex]);
+        return TraversalControl::Continue;
+    }
+};
+
+#endif
@@ -7,23 +7,33 @@
 #include <set>
 #include <algorithm>
 #include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "../../common/src/CsrTraversal.h"
 
 class GraphData {
 private:
     // キーは頂点、値は隣接頂点と重みのペアのベクタ
     std::unordered_map<std::string, std::vector<std::pair<std::string, int>>> _data;
 
-    void _dfs(const std::string& vertex, std::set<std::string>& visited, std::vector<std::string>& current_component) {
-        visited.insert(vertex);
-        current_component.push_back(vertex);
-
-        // 隣接頂点を探索
-        for (const auto& neighbor_info : _data[vertex]) {
-            const std::string& neighbor_vertex = neighbor_info.first;
-            if (visited.find(neighbor_vertex) == visited.end()) {
-                _dfs(neighbor_vertex, visited, current_component);
+    // get_vertices の順に振ったIDの CSR を作ります (隣接頂点は辺を追加した順)。
+    CsrGraph _build_csr() const {
+        CsrGraph csr;
+        csr.names = get_vertices();
+        for (size_t i = 0; i < csr.names.size(); ++i) {
+            csr.index[csr.names[i]] = static_cast<int>(i);
+        }
+        csr.offsets.reserve(csr.names.size() + 1);
+        csr.offsets.push_back(0);
+        for (const std::string& vertex : csr.names) {
+            for (const auto& neighbor_info : _data.at(vertex)) {
+                csr.targets.push_back(csr.index[neighbor_info.first]);
+                csr.weights.push_back(neighbor_info.second);
             }
+            csr.offsets.push_back(static_cast<int>(csr.targets.size()));
         }
+        return csr;
     }
 
 public:
@@ -85,19 +95,17 @@ public:
         return true;
     }
 
-    std::vector<std::vector<std::string>> get_connected_components() {
-        std::set<std::string> visited;
-        std::vector<std::vector<std::string>> connected_components;
-
-        for (const auto& vertex : get_vertices()) {
-            if (visited.find(vertex) == visited.end()) {
-                std::vector<std::string> current_component;
-                _dfs(vertex, visited, current_component);
-                connected_components.push_back(current_component);
-            }
+    // 深さ優先探索で連結成分を見つける (再帰を使わないため、深いグラフでもスタックが溢れない)
+    std::vector<std::vector<std::string>> get_connected_components() const {
+        CsrGraph csr = _build_csr();
+        std::vector<int> sources(csr.num_vertices());
+        for (int v = 0; v < csr.num_vertices(); ++v) {
+            sources[v] = v;
         }
-
-        return connected_components;
+        ComponentCollector collector(csr);
+        TraversalWorkspace workspace;
+        traverse_csr(csr, sources, TraversalOrder::Depth, collector, workspace);
+        return collector.components;
     }
 };
 
@@ -8,8 +8,253 @@
 #include <set>
 #include <utility>
 #include <algorithm>
+#include <functional>
 #include <string>
 #include <tuple>
+#include <cstdio>
+
+// for_each_line の結果
+enum class LineReadStatus {
+    Ok,
+    OpenFailed,   // ファイルを開けない
+    ReadFailed,   // 読み込み中の入出力エラー
+    LineTooLong,  // バッファに収まらない行がある
+    Stopped       // on_line が false を返して読むのをやめた
+};
+
+// 辺リストのファイルを先頭から順に buffer_size バイトずつ読み、
+// 1行ごとに on_line(行の先頭, 行の長さ) を呼び出します。on_line は続けて読むなら true を返し、
+// false を返すとファイルの残りを読まずに LineReadStatus::Stopped を返します。
+// バッファは広げないため、使うメモリは buffer_size バイトのままです。
+// buffer_size より長い行があった場合や、読み込みでエラーが起きた場合は、そこで読むのをやめてエラーを返します。
+template <typename OnLine>
+LineReadStatus for_each_line(const std::string& path, size_t buffer_size, OnLine on_line) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return LineReadStatus::OpenFailed;
+    }
+    std::vector<char> buffer(std::max<size_t>(buffer_size, 2));
+    size_t carry = 0;  // 前回の読み込みで行の途中まで読んだバイト数
+    LineReadStatus status = LineReadStatus::Ok;
+    while (true) {
+        size_t read = std::fread(buffer.data() + carry, 1, buffer.size() - carry, file);
+        if (read < buffer.size() - carry && std::ferror(file)) {
+            // 短い読み込みはファイルの終わりとは限らない
+            status = LineReadStatus::ReadFailed;
+            break;
+        }
+        size_t end = carry + read;
+        size_t line_start = 0;
+        for (size_t i = 0; i < end && status == LineReadStatus::Ok; ++i) {
+            if (buffer[i] == '\n') {
+                if (!on_line(buffer.data() + line_start, i - line_start)) {
+                    status = LineReadStatus::Stopped;
+                }
+                line_start = i + 1;
+            }
+        }
+        if (status != LineReadStatus::Ok) {
+            break;
+        }
+        carry = end - line_start;
+        if (read == 0) {
+            // 改行で終わらない最後の行
+            if (carry > 0 && !on_line(buffer.data() + line_start, carry)) {
+                status = LineReadStatus::Stopped;
+            }
+            break;
+        }
+        if (carry == buffer.size()) {
+            status = LineReadStatus::LineTooLong;
+            break;
+        }
+        std::copy(buffer.begin() + line_start, buffer.begin() + end, buffer.begin());
+    }
+    std::fclose(file);
+    return status;
+}
+
+// 頂点の状態 (頂点名、親、サイズ) だけをメモリに置く Union-Find です (準外部メモリ)。
+// 辺はメモリに保持せず、読んだそばから union_sets に渡します。
+class SemiExternalUnionFind {
+private:
+    std::unordered_map<std::string, int> _index;
+    std::vector<const std::string*> _names;  // ID -> 頂点名 (_index のキーを指す)
+    std::vector<int> _parent;
+    std::vector<int> _size;
+    size_t _name_bytes = 0;
+
+public:
+    // 頂点のIDを返します。初めて現れた頂点には新しいIDを振ります。
+    int vertex_id(const std::string& name) {
+        auto it = _index.find(name);
+        if (it != _index.end()) {
+            return it->second;
+        }
+        int id = static_cast<int>(_parent.size());
+        it = _index.emplace(name, id).first;
+        _names.push_back(&it->first);
+        _parent.push_back(id);
+        _size.push_back(1);
+        _name_bytes += it->first.capacity();
+        return id;
+    }
+
+    int num_vertices() const {
+        return static_cast<int>(_parent.size());
+    }
+
+    const std::string& name(int vertex) const {
+        return *_names[vertex];
+    }
+
+    // 根を探します (経路半減、再帰しない)。
+    int find(int vertex) {
+        while (_parent[vertex] != vertex) {
+            _parent[vertex] = _parent[_parent[vertex]];
+            vertex = _parent[vertex];
+        }
+        return vertex;
+    }
+
+    // 2つの頂点の集合を結合します (Union by Size)。
+    bool union_sets(int u, int v) {
+        int root_u = find(u);
+        int root_v = find(v);
+        if (root_u == root_v) {
+            return false;
+        }
+        if (_size[root_u] < _size[root_v]) {
+            std::swap(root_u, root_v);
+        }
+        _parent[root_v] = root_u;
+        _size[root_u] += _size[root_v];
+        return true;
+    }
+
+    // 頂点の状態が使うメモリのおおよそのバイト数 (ハッシュ表のノードとバケットを含む)
+    size_t state_bytes() const {
+        size_t node_bytes = sizeof(std::pair<const std::string, int>) + 2 * sizeof(void*);
+        return _parent.capacity() * 2 * sizeof(int) + _names.capacity() * sizeof(void*)
+             + _index.size() * node_bytes + _index.bucket_count() * sizeof(void*) + _name_bytes;
+    }
+
+    // 各頂点の連結成分番号 (頂点が初めて現れた順に 0 から振る) の配列を返します。
+    // サイズの配列を番号の格納に使い回すため、呼び出した後は union_sets を使えません。
+    std::vector<int>& label_components(int& num_components) {
+        std::fill(_size.begin(), _size.end(), -1);
+        num_components = 0;
+        for (int v = 0; v < num_vertices(); ++v) {
+            int root = find(v);
+            if (_size[root] == -1) {
+                _size[root] = num_components++;
+            }
+            _size[v] = _size[root];
+        }
+        return _size;
+    }
+};
+
+// 外部メモリでの連結成分の計算結果
+struct ExternalComponentsResult {
+    bool success = false;
+    long long num_vertices = 0;
+    long long num_edges = 0;       // 読んだ辺の数
+    long long num_components = 0;
+    size_t peak_bytes = 0;         // 頂点の状態と読み込みバッファのおおよその最大使用量
+};
+
+// メモリに載らないグラフの連結成分を、ディスク上の辺リストを先頭から順に1回読むだけで求めます。
+// 辺リストは1行に "頂点1 頂点2 [重み]" の形式で、空行と '#' で始まる行は読み飛ばします。
+// メモリに置くのは頂点の状態と読み込みバッファだけで、その合計が memory_budget バイトを
+// 超えそうになった場合はエラーとして中断します。
+// 結果は output_file に1行に "頂点 連結成分番号" の形式で書き出します。
+ExternalComponentsResult get_connected_components_external(
+    const std::string& edge_file,
+    const std::string& output_file,
+    size_t memory_budget
+) {
+    ExternalComponentsResult result;
+    // 読み込みバッファは上限の 1/16 (64KB 以上 16MB 以下)
+    const size_t buffer_size = std::min<size_t>(std::max<size_t>(memory_budget / 16, 1 << 16), 1 << 24);
+    if (memory_budget <= buffer_size) {
+        std::cout << "ERROR: メモリの上限 " << memory_budget << " バイトが小さすぎます。" << std::endl;
+        return result;
+    }
+
+    SemiExternalUnionFind union_find;
+    bool over_budget = false;
+    std::string vertex1;
+    std::string vertex2;
+    LineReadStatus status = for_each_line(edge_file, buffer_size, [&](const char* line, size_t length) {
+        // 先頭の2つの語を頂点名として取り出す (3つ目の重みは連結成分には使わない)
+        size_t i = 0;
+        auto next_word = [&](std::string& word) {
+            while (i < length && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) {
+                ++i;
+            }
+            size_t start = i;
+            while (i < length && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') {
+                ++i;
+            }
+            word.assign(line + start, i - start);
+            return !word.empty();
+        };
+        if (!next_word(vertex1) || vertex1[0] == '#' || !next_word(vertex2)) {
+            return true;
+        }
+        int u = union_find.vertex_id(vertex1);
+        int v = union_find.vertex_id(vertex2);
+        union_find.union_sets(u, v);
+        ++result.num_edges;
+        size_t used = union_find.state_bytes() + buffer_size;
+        result.peak_bytes = std::max(result.peak_bytes, used);
+        if (used > memory_budget) {
+            // 上限を超えたら、辺リストの残りを読まずにすぐ中断する
+            over_budget = true;
+            return false;
+        }
+        return true;
+    });
+    if (status == LineReadStatus::OpenFailed) {
+        std::cout << "ERROR: 辺リスト '" << edge_file << "' を開けません。" << std::endl;
+        return result;
+    }
+    if (status == LineReadStatus::ReadFailed) {
+        std::cout << "ERROR: 辺リスト '" << edge_file << "' の読み込み中にエラーが起きました。" << std::endl;
+        return result;
+    }
+    if (status == LineReadStatus::LineTooLong) {
+        std::cout << "ERROR: 辺リスト '" << edge_file << "' に読み込みバッファ (" << buffer_size
+                  << " バイト) より長い行があります。" << std::endl;
+        return result;
+    }
+    if (over_budget) {
+        std::cout << "ERROR: 頂点の状態がメモリの上限 " << memory_budget << " バイトを超えました。" << std::endl;
+        return result;
+    }
+
+    std::FILE* output = std::fopen(output_file.c_str(), "wb");
+    if (output == nullptr) {
+        std::cout << "ERROR: 出力ファイル '" << output_file << "' を開けません。" << std::endl;
+        return result;
+    }
+    int num_components = 0;
+    const std::vector<int>& labels = union_find.label_components(num_components);
+    for (int v = 0; v < union_find.num_vertices(); ++v) {
+        std::fprintf(output, "%s %d\n", union_find.name(v).c_str(), labels[v]);
+    }
+    bool write_failed = std::ferror(output) != 0;
+    if (std::fclose(output) != 0 || write_failed) {
+        std::cout << "ERROR: 出力ファイル '" << output_file << "' の書き込み中にエラーが起きました。" << std::endl;
+        return result;
+    }
+
+    result.success = true;
+    result.num_vertices = union_find.num_vertices();
+    result.num_components = num_components;
+    return result;
+}
 
 class GraphData {
 private:
@@ -113,6 +358,20 @@ public:
         return true;
     }
 
+    // グラフの全辺を1行に "頂点1 頂点2 重み" の形式でファイルに書き出す
+    // (get_connected_components_external の入力になります)
+    bool save_edge_list(const std::string& path) {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        for (const auto& edge : get_edges()) {
+            std::fprintf(file, "%s %s %d\n", std::get<0>(edge).c_str(), std::get<1>(edge).c_str(), std::get<2>(edge));
+        }
+        std::fclose(file);
+        return true;
+    }
+
     // 連結成分を取得
     std::vector<std::vector<std::string>> get_connected_components() {
         if (_data.empty()) {
@@ -293,6 +552,37 @@ int main() {
     }
     std::cout << "]" << std::endl;
 
+    std::cout << "\nget_connected_components_external" << std::endl;
+    graph_data.clear();
+    for (const auto& input : inputList2) {
+        graph_data.add_edge(std::get<0>(input), std::get<1>(input), std::get<2>(input));
+    }
+    const std::string edge_file = "union_find_edges.tmp";
+    const std::string component_file = "union_find_components.tmp";
+    graph_data.save_edge_list(edge_file);
+    ExternalComponentsResult external = get_connected_components_external(edge_file, component_file, 1 << 20);
+    std::cout << "  頂点: " << external.num_vertices << ", 辺: " << external.num_edges
+              << ", 連結成分: " << external.num_components << std::endl;
+    std::map<int, std::vector<std::string>> external_components;
+    for_each_line(component_file, 1 << 16, [&](const char* line, size_t length) {
+        std::string text(line, length);
+        size_t space = text.rfind(' ');
+        external_components[std::stoi(text.substr(space + 1))].push_back(text.substr(0, space));
+        return true;
+    });
+    std::cout << "  連結成分: [";
+    for (auto it = external_components.begin(); it != external_components.end(); ++it) {
+        std::cout << (it == external_components.begin() ? "[" : ", [");
+        for (size_t j = 0; j < it->second.size(); ++j) {
+            std::cout << "'" << it->second[j] << "'";
+            if (j < it->second.size() - 1) std::cout << ", ";
+        }
+        std::cout << "]";
+    }
+    std::cout << "]" << std::endl;
+    std::remove(edge_file.c_str());
+    std::remove(component_file.c_str());
+
     std::cout << "\nUnionFind TEST <----- end" << std::endl;
     
     return 0;
@@ -9,6 +9,73 @@
 #include <algorithm>
 #include <utility>
 #include <string>
+#include <numeric>
+
+// 単連結法 (single linkage) による階層的クラスタリングの1回の併合です。
+// クラスタ番号は 0..n-1 が元の頂点 (SingleLinkage::labels の位置)、n + i が i 番目の併合でできたクラスタです。
+// (SciPy の linkage 行列と同じ形式です)
+template <typename Weight>
+struct BasicLinkageStep {
+    int cluster1;
+    int cluster2;
+    Weight weight;
+    int size;     // 併合後のクラスタの頂点数
+};
+
+// 単連結法のデンドログラムです。steps は重みの小さい順に並びます。
+// グラフが連結でない場合、steps は n - (連結成分の数) 個になります。
+template <typename Weight>
+struct BasicSingleLinkage {
+    std::vector<std::string> labels;
+    std::vector<BasicLinkageStep<Weight>> steps;
+};
+
+typedef BasicLinkageStep<int> LinkageStep;
+typedef BasicSingleLinkage<int> SingleLinkage;
+
+// 整数IDの頂点を扱う Union-Find です。
+// 文字列をキーにする DSU と違い、配列だけで表現するためハッシュ計算やメモリ確保がありません。
+class IntDSU {
+private:
+    std::vector<int> parent;
+    std::vector<int> size;
+
+public:
+    IntDSU(int num_vertices) : parent(num_vertices), size(num_vertices, 1) {
+        std::iota(parent.begin(), parent.end(), 0);
+    }
+
+    // 頂点 i が属する集合の代表元（根）を見つけます (経路半減)。
+    int find(int i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+
+    // 頂点 i と 頂点 j を含む二つの集合を結合し、結合後の根を返します。
+    // 既に同じ集合に属していた場合は -1 を返します。
+    int union_sets(int i, int j) {
+        int root_i = find(i);
+        int root_j = find(j);
+        if (root_i == root_j) {
+            return -1;
+        }
+        // 小さい方の木を大きい方の木の根に付けます。
+        if (size[root_i] < size[root_j]) {
+            std::swap(root_i, root_j);
+        }
+        parent[root_j] = root_i;
+        size[root_i] += size[root_j];
+        return root_i;
+    }
+
+    // 頂点 i が属する集合の大きさを返します。
+    int set_size(int i) {
+        return size[find(i)];
+    }
+};
 
 class DSU {
 private:
@@ -62,13 +129,17 @@ public:
 };
 
 // 重みを扱えるように改変された GraphData クラス
-class GraphData {
+// 辺の重みの型 Weight を指定できます (整数・浮動小数点数のどちらも使えます)。
+// クラスカル法は重みの比較だけで辺を選ぶため、重みを足し合わせることはなく、重みの型の範囲を超えることもありません。
+// 例えば BasicGraphData<unsigned short> で2バイトの重みを、BasicGraphData<double> で実数の重みを扱えます。
+template <typename Weight>
+class BasicGraphData {
 private:
     // 隣接ノードとその辺の重みを格納します。
-    std::unordered_map<std::string, std::vector<std::pair<std::string, int>>> _data;
+    std::unordered_map<std::string, std::vector<std::pair<std::string, Weight>>> _data;
 
 public:
-    std::unordered_map<std::string, std::vector<std::pair<std::string, int>>> get() {
+    std::unordered_map<std::string, std::vector<std::pair<std::string, Weight>>> get() {
         // グラフの内部データを取得します。
         return _data;
     }
@@ -82,16 +153,16 @@ public:
         return vertices;
     }
 
-    std::vector<std::tuple<std::string, std::string, int>> get_edges() {
+    std::vector<std::tuple<std::string, std::string, Weight>> get_edges() {
         // グラフの全辺をリストとして返します。
         // 無向グラフの場合、(u, v, weight) の形式で返します。
         // 重複を避けるためにセットを使用します。
-        std::set<std::tuple<std::string, std::string, int>> edges;
+        std::set<std::tuple<std::string, std::string, Weight>> edges;
         for (const auto& vertex_entry : _data) {
             const std::string& vertex = vertex_entry.first;
             for (const auto& neighbor_entry : vertex_entry.second) {
                 const std::string& neighbor = neighbor_entry.first;
-                int weight = neighbor_entry.second;
+                Weight weight = neighbor_entry.second;
                 
                 // 辺を正規化してセットに追加 (小さい方の頂点を最初にするなど)
                 std::string u = vertex;
@@ -101,7 +172,7 @@ public:
                 edges.insert(std::make_tuple(u, v, weight)); // (u, v, weight) の形式で格納
             }
         }
-        return std::vector<std::tuple<std::string, std::string, int>>(edges.begin(), edges.end());
+        return std::vector<std::tuple<std::string, std::string, Weight>>(edges.begin(), edges.end());
     }
 
     bool add_vertex(const std::string& vertex) {
@@ -114,7 +185,7 @@ public:
         return true;
     }
 
-    bool add_edge(const std::string& vertex1, const std::string& vertex2, int weight) {
+    bool add_edge(const std::string& vertex1, const std::string& vertex2, Weight weight) {
         // 両頂点間に辺を追加します。重みを指定します。
         // 頂点がグラフに存在しない場合は追加します。
         if (_data.find(vertex1) == _data.end()) {
@@ -161,13 +232,13 @@ public:
         return true;
     }
 
-    std::vector<std::tuple<std::string, std::string, int>> get_mst() {
+    std::vector<std::tuple<std::string, std::string, Weight>> get_mst() {
         // 1. 全ての辺を取得し、重みでソートします。
         // get_edges() は (u, v, weight) のリストを返します。
         auto edges = get_edges();
         // 重み (タプルの3番目の要素) をキーとして辺をソート
         std::sort(edges.begin(), edges.end(), 
-            [](const std::tuple<std::string, std::string, int>& a, const std::tuple<std::string, std::string, int>& b) {
+            [](const std::tuple<std::string, std::string, Weight>& a, const std::tuple<std::string, std::string, Weight>& b) {
                 return std::get<2>(a) < std::get<2>(b);
             });
 
@@ -178,7 +249,7 @@ public:
 
         // 3. MSTを構築します。
         // 結果として得られるMSTの辺を格納するリスト
-        std::vector<std::tuple<std::string, std::string, int>> mst_edges;
+        std::vector<std::tuple<std::string, std::string, Weight>> mst_edges;
         // MSTに追加された辺の数 (頂点数-1 になればMSTが完成)
         size_t edges_count = 0;
 
@@ -186,7 +257,6 @@ public:
         for (const auto& edge : edges) {
             const std::string& u = std::get<0>(edge);
             const std::string& v = std::get<1>(edge);
-            int weight = std::get<2>(edge);
             
             // 辺 (u, v) の両端点が属する集合の代表元（根）を見つけます。
             std::string root_u = dsu.find(u);
@@ -213,8 +283,73 @@ public:
         // MST (または最小全域森) の辺のリストを返します。
         return mst_edges;
     }
+
+    BasicSingleLinkage<Weight> get_single_linkage() {
+        // 最小全域森の辺を重みの小さい順に併合して、単連結法のデンドログラムを作ります。
+        // 頂点は名前順に 0..n-1 の番号を付け、併合には整数IDの Union-Find を使います。
+        BasicSingleLinkage<Weight> linkage;
+        linkage.labels = get_vertices();
+        std::sort(linkage.labels.begin(), linkage.labels.end());
+        std::unordered_map<std::string, int> index;
+        for (size_t i = 0; i < linkage.labels.size(); ++i) {
+            index[linkage.labels[i]] = static_cast<int>(i);
+        }
+
+        // get_mst() は重みの小さい順に辺を返します。
+        const int num_vertices = static_cast<int>(linkage.labels.size());
+        IntDSU dsu(num_vertices);
+        // 各集合の根 -> その集合を表すクラスタ番号
+        std::vector<int> cluster_of_root(num_vertices);
+        std::iota(cluster_of_root.begin(), cluster_of_root.end(), 0);
+        for (const auto& edge : get_mst()) {
+            int root_u = dsu.find(index[std::get<0>(edge)]);
+            int root_v = dsu.find(index[std::get<1>(edge)]);
+            int cluster_u = cluster_of_root[root_u];
+            int cluster_v = cluster_of_root[root_v];
+            int root = dsu.union_sets(root_u, root_v);
+            linkage.steps.push_back(BasicLinkageStep<Weight>{
+                std::min(cluster_u, cluster_v), std::max(cluster_u, cluster_v),
+                std::get<2>(edge), dsu.set_size(root)});
+            cluster_of_root[root] = num_vertices + static_cast<int>(linkage.steps.size()) - 1;
+        }
+        return linkage;
+    }
+
+    std::vector<std::vector<std::string>> get_clusters(size_t k) {
+        // 単連結法のデンドログラムを k 個のクラスタになる位置で切ったときの各クラスタを返します。
+        // 連結成分が k 個より多い場合は、連結成分ごとのクラスタ (k 個より多い) を返します。
+        // 各クラスタは頂点の名前順で、クラスタは先頭の頂点の名前順に並びます。
+        BasicSingleLinkage<Weight> linkage = get_single_linkage();
+        const int num_vertices = static_cast<int>(linkage.labels.size());
+        size_t merges = num_vertices > static_cast<int>(k) ? num_vertices - k : 0;
+        merges = std::min(merges, linkage.steps.size());
+
+        // 先頭から merges 個の併合だけを適用する (クラスタ番号 n + i は i 番目の併合の結果)
+        IntDSU dsu(num_vertices);
+        std::vector<int> representative(num_vertices + linkage.steps.size());
+        std::iota(representative.begin(), representative.begin() + num_vertices, 0);
+        for (size_t i = 0; i < merges; ++i) {
+            const BasicLinkageStep<Weight>& step = linkage.steps[i];
+            dsu.union_sets(representative[step.cluster1], representative[step.cluster2]);
+            representative[num_vertices + i] = representative[step.cluster1];
+        }
+
+        std::vector<std::vector<std::string>> clusters;
+        std::vector<int> cluster_index(num_vertices, -1);
+        for (int v = 0; v < num_vertices; ++v) {
+            int root = dsu.find(v);
+            if (cluster_index[root] == -1) {
+                cluster_index[root] = static_cast<int>(clusters.size());
+                clusters.emplace_back();
+            }
+            clusters[cluster_index[root]].push_back(linkage.labels[v]);
+        }
+        return clusters;
+    }
 };
 
+typedef BasicGraphData<int> GraphData;
+
 int main() {
     std::cout << "Kruskal TEST -----> start" << std::endl;
     GraphData graph_data;
@@ -329,6 +464,46 @@ int main() {
     }
     std::cout << "最小全域木の合計重み: " << total_weight << std::endl;
 
+    graph_data.clear();
+    inputList = {{"A", "B", 1}, {"B", "C", 2}, {"C", "D", 6}, {"D", "E", 1}, {"E", "F", 3}, {"G", "H", 2}};
+    for (const auto& input : inputList) {
+        graph_data.add_edge(std::get<0>(input), std::get<1>(input), std::get<2>(input));
+    }
+    SingleLinkage linkage = graph_data.get_single_linkage();
+    std::cout << "\n単連結法のデンドログラム (クラスタ1, クラスタ2, 重み, 大きさ):" << std::endl;
+    for (const auto& step : linkage.steps) {
+        std::cout << "  (" << step.cluster1 << ", " << step.cluster2 << ", " << step.weight << ", " << step.size << ")" << std::endl;
+    }
+    for (size_t k : {3, 4}) {
+        std::cout << k << " 個のクラスタ:";
+        for (const auto& cluster : graph_data.get_clusters(k)) {
+            std::cout << " [";
+            for (size_t i = 0; i < cluster.size(); ++i) {
+                std::cout << (i == 0 ? "" : ", ") << cluster[i];
+            }
+            std::cout << "]";
+        }
+        std::cout << std::endl;
+    }
+
+    // 重みの型を変えても同じ最小全域木が得られる (2バイトの重み、浮動小数点数の重み)
+    BasicGraphData<unsigned short> compact_graph;
+    BasicGraphData<double> double_graph;
+    for (const auto& input : inputList) {
+        compact_graph.add_edge(std::get<0>(input), std::get<1>(input), static_cast<unsigned short>(std::get<2>(input)));
+        double_graph.add_edge(std::get<0>(input), std::get<1>(input), std::get<2>(input) / 2.0);
+    }
+    unsigned int compact_total = 0;
+    for (const auto& edge : compact_graph.get_mst()) {
+        compact_total += std::get<2>(edge);
+    }
+    double double_total = 0;
+    for (const auto& edge : double_graph.get_mst()) {
+        double_total += std::get<2>(edge);
+    }
+    std::cout << "\nunsigned short の重みの最小全域森の合計重み: " << compact_total << std::endl;
+    std::cout << "double の重み (半分) の最小全域森の合計重み: " << double_total << std::endl;
+
     std::cout << "\nKruskal TEST <----- end" << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -9,18 +9,159 @@
 #include <limits>
 #include <algorithm>
 #include <tuple>
+#include <thread>
+#include <atomic>
+#include <numeric>
+#include <cmath>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ARGMIN_KEY_X86 1
+#else
+#define ARGMIN_KEY_X86 0
+#endif
 
-class GraphData {
+// key[0..n) の最小値の位置を返します (最小値が複数あれば最も小さい位置)。スカラー版です。
+int argmin_key_scalar(const double* key, int n) {
+    int best = 0;
+    for (int i = 1; i < n; ++i) {
+        if (key[i] < key[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+#if ARGMIN_KEY_X86
+// AVX2 版: 4要素ずつまとめて比較し、レーンごとの最小値とその位置を求めてから1つにまとめます。結果はスカラー版と一致します。
+__attribute__((target("avx2")))
+int argmin_key_avx2(const double* key, int n) {
+    if (n < 8) {
+        return argmin_key_scalar(key, n);
+    }
+    __m256d best_values = _mm256_loadu_pd(key);
+    __m256d best_indices = _mm256_set_pd(3, 2, 1, 0);
+    __m256d indices = best_indices;
+    const __m256d step = _mm256_set1_pd(4);
+    int i = 4;
+    for (; i + 4 <= n; i += 4) {
+        indices = _mm256_add_pd(indices, step);
+        __m256d values = _mm256_loadu_pd(key + i);
+        __m256d smaller = _mm256_cmp_pd(values, best_values, _CMP_LT_OQ);
+        best_values = _mm256_blendv_pd(best_values, values, smaller);
+        best_indices = _mm256_blendv_pd(best_indices, indices, smaller);
+    }
+    double lane_values[4];
+    double lane_indices[4];
+    _mm256_storeu_pd(lane_values, best_values);
+    _mm256_storeu_pd(lane_indices, best_indices);
+    int best = static_cast<int>(lane_indices[0]);
+    for (int lane = 1; lane < 4; ++lane) {
+        int index = static_cast<int>(lane_indices[lane]);
+        if (lane_values[lane] < key[best] || (lane_values[lane] == key[best] && index < best)) {
+            best = index;
+        }
+    }
+    for (; i < n; ++i) {
+        if (key[i] < key[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+#endif
+
+// 実行中の CPU で使える argmin_key の実装を選びます (AVX2 > スカラー)。
+int (*select_argmin_key())(const double*, int) {
+#if ARGMIN_KEY_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return argmin_key_avx2;
+    }
+#endif
+    return argmin_key_scalar;
+}
+
+// key[0..n) の最小値の位置を返します (最小値が複数あれば最も小さい位置)。
+// 実装は最初の呼び出しで CPU の命令セットを調べて1度だけ選ぶため、-mavx2 なしでビルドしても AVX2 版を使えます。
+int argmin_key(const double* key, int n) {
+    static int (*const kernel)(const double*, int) = select_argmin_key();
+    return kernel(key, n);
+}
+
+// 密グラフ (完全グラフなど) 用の O(V^2) のプリム法で、頂点 0 を含む最小全域木を計算します。
+// distance(u, v) は頂点 u, v 間の辺の重みを返す関数で、辺がなければ無限大を返します。
+// 辺を E 本すべて作ることはせず、距離は必要になったときに計算します (点群の距離など)。
+// 未確定の頂点とその最小コスト key[] は連続した配列に詰めて保持し、次の頂点は argmin_key で選びます。
+// 戻り値は (遷移元の頂点, 追加した頂点, 重み) を追加した順に並べたものです。
+template <typename Distance>
+std::vector<std::tuple<int, int, double>> get_dense_mst(int num_vertices, Distance distance) {
+    std::vector<std::tuple<int, int, double>> mst_edges;
+    if (num_vertices <= 0) {
+        return mst_edges;
+    }
+
+    // 未確定の頂点の ID・最小コスト・遷移元 (確定した頂点は末尾と入れ替えて取り除く)
+    std::vector<int> remaining(num_vertices - 1);
+    std::vector<double> key(num_vertices - 1);
+    std::vector<int> parent(num_vertices - 1, 0);
+    for (int i = 0; i < num_vertices - 1; ++i) {
+        remaining[i] = i + 1;
+        key[i] = distance(0, i + 1);
+    }
+
+    int count = num_vertices - 1;
+    while (count > 0) {
+        int position = argmin_key(key.data(), count);
+        if (key[position] == std::numeric_limits<double>::infinity()) {
+            break; // 残りの頂点には到達できない
+        }
+        int u = remaining[position];
+        mst_edges.push_back(std::make_tuple(parent[position], u, key[position]));
+
+        --count;
+        remaining[position] = remaining[count];
+        key[position] = key[count];
+        parent[position] = parent[count];
+
+        // 新しく追加した頂点 u からの距離で最小コストを更新する (分岐のない選択で書く)
+        for (int i = 0; i < count; ++i) {
+            double d = distance(u, remaining[i]);
+            bool closer = d < key[i];
+            key[i] = closer ? d : key[i];
+            parent[i] = closer ? u : parent[i];
+        }
+    }
+    return mst_edges;
+}
+
+// num_vertices x num_vertices の距離行列 (行優先) に対する密グラフ用のプリム法です。
+std::vector<std::tuple<int, int, double>> get_dense_mst(const std::vector<double>& matrix, int num_vertices) {
+    return get_dense_mst(num_vertices, [&matrix, num_vertices](int u, int v) {
+        return matrix[static_cast<size_t>(u) * num_vertices + v];
+    });
+}
+
+// 辺の重みの型 Weight を指定できるグラフです (整数・浮動小数点数のどちらも使えます)。
+// 最小全域木は重みの比較だけで決まるため、重みを足し合わせることはなく、重みの型の範囲を超えることもありません。
+// 例えば BasicGraphData<unsigned short> で2バイトの重みを、BasicGraphData<double> で実数の重みを扱えます。
+template <typename Weight>
+class BasicGraphData {
 private:
     // 隣接リストとしてグラフデータを格納します。
     // キーは頂点、値はその頂点に隣接する頂点とその辺の重みのペアのベクトルです。
-    std::map<std::string, std::vector<std::pair<std::string, int>>> _data;
+    std::map<std::string, std::vector<std::pair<std::string, Weight>>> _data;
+
+    // まだ辺が見つかっていない頂点の最小コスト (どの重みよりも大きい値)
+    static Weight no_cost() {
+        return std::numeric_limits<Weight>::has_infinity ? std::numeric_limits<Weight>::infinity()
+                                                         : std::numeric_limits<Weight>::max();
+    }
 
 public:
-    GraphData() {}
+    BasicGraphData() {}
 
     // グラフの内部データを取得します。
-    std::map<std::string, std::vector<std::pair<std::string, int>>>& get() {
+    std::map<std::string, std::vector<std::pair<std::string, Weight>>>& get() {
         return _data;
     }
 
@@ -35,16 +176,16 @@ public:
 
     // グラフの全辺をリストとして返します。
     // 無向グラフの場合、(u, v, weight) の形式で返します。
-    std::vector<std::tuple<std::string, std::string, int>> get_edges() {
-        std::set<std::tuple<std::string, std::string, int>> edges;
+    std::vector<std::tuple<std::string, std::string, Weight>> get_edges() {
+        std::set<std::tuple<std::string, std::string, Weight>> edges;
         for (const auto& vertex_pair : _data) {
             for (const auto& neighbor_weight : vertex_pair.second) {
                 std::string vertex = vertex_pair.first;
                 std::string neighbor = neighbor_weight.first;
-                int weight = neighbor_weight.second;
+                Weight weight = neighbor_weight.second;
                 
                 // 辺を正規化してセットに追加 (小さい方の頂点を最初にするなど)
-                std::tuple<std::string, std::string, int> edge;
+                std::tuple<std::string, std::string, Weight> edge;
                 if (vertex < neighbor) {
                     edge = std::make_tuple(vertex, neighbor, weight);
                 } else {
@@ -53,20 +194,20 @@ public:
                 edges.insert(edge);
             }
         }
-        return std::vector<std::tuple<std::string, std::string, int>>(edges.begin(), edges.end());
+        return std::vector<std::tuple<std::string, std::string, Weight>>(edges.begin(), edges.end());
     }
 
     // 指定された頂点の隣接ノードと辺の重みのリストを返します。
-    std::vector<std::pair<std::string, int>> get_neighbors(const std::string& vertex) {
+    std::vector<std::pair<std::string, Weight>> get_neighbors(const std::string& vertex) {
         if (_data.find(vertex) != _data.end()) {
             return _data[vertex];
         }
-        return std::vector<std::pair<std::string, int>>(); // 頂点が存在しない場合は空のベクトルを返す
+        return std::vector<std::pair<std::string, Weight>>(); // 頂点が存在しない場合は空のベクトルを返す
     }
 
     // 指定された2つの頂点間の辺の重みを返します。
-    // 辺が存在しない場合は-1を返します。
-    int get_edge_weight(const std::string& vertex1, const std::string& vertex2) {
+    // 辺が存在しない場合は-1 (符号なしの型では最大値) を返します。
+    Weight get_edge_weight(const std::string& vertex1, const std::string& vertex2) {
         if (_data.find(vertex1) != _data.end() && _data.find(vertex2) != _data.end()) {
             for (const auto& neighbor_weight : _data[vertex1]) {
                 if (neighbor_weight.first == vertex2) {
@@ -74,19 +215,19 @@ public:
                 }
             }
         }
-        return -1; // 辺が存在しない場合
+        return static_cast<Weight>(-1); // 辺が存在しない場合
     }
 
     // 新しい頂点をグラフに追加します。
     bool add_vertex(const std::string& vertex) {
         if (_data.find(vertex) == _data.end()) {
-            _data[vertex] = std::vector<std::pair<std::string, int>>();
+            _data[vertex] = std::vector<std::pair<std::string, Weight>>();
         }
         return true;
     }
 
     // 両頂点間に辺を追加します。重みを指定します。
-    bool add_edge(const std::string& vertex1, const std::string& vertex2, int weight) {
+    bool add_edge(const std::string& vertex1, const std::string& vertex2, Weight weight) {
         if (_data.find(vertex1) == _data.end()) {
             add_vertex(vertex1);
         }
@@ -135,7 +276,7 @@ public:
     }
 
     // 最小全域木を計算します
-    std::vector<std::tuple<std::string, std::string, int>> get_mst(const std::string* start_vertex = nullptr) {
+    std::vector<std::tuple<std::string, std::string, Weight>> get_mst(const std::string* start_vertex = nullptr) {
         std::vector<std::string> vertices = get_vertices();
         if (vertices.empty()) {
             return {}; // グラフが空
@@ -156,29 +297,29 @@ public:
         
         // 優先度付きキュー (重み, 現在の頂点, 遷移元の頂点)
         // C++の優先度キューはデフォルトで最大ヒープなので、重みを負にして最小ヒープとして使用
-        using PQElement = std::tuple<int, std::string, std::string>;
+        using PQElement = std::tuple<Weight, std::string, std::string>;
         std::priority_queue<PQElement, std::vector<PQElement>, std::greater<PQElement>> min_heap;
         
         // MSTを構成する辺のリスト
-        std::vector<std::tuple<std::string, std::string, int>> mst_edges;
+        std::vector<std::tuple<std::string, std::string, Weight>> mst_edges;
         
         // 各頂点への最小コスト（MSTに追加する際の辺の重み）
-        std::map<std::string, int> min_cost;
+        std::map<std::string, Weight> min_cost;
         std::map<std::string, std::string> parent;
         
         // 初期化
         for (const auto& v : vertices) {
-            min_cost[v] = std::numeric_limits<int>::max();
+            min_cost[v] = no_cost();
             parent[v] = "";
         }
 
         // 開始頂点の処理
-        min_cost[start] = 0;
-        min_heap.push(std::make_tuple(0, start, "")); // (コスト, 現在の頂点, 遷移元の頂点)
+        min_cost[start] = Weight();
+        min_heap.push(std::make_tuple(Weight(), start, "")); // (コスト, 現在の頂点, 遷移元の頂点)
 
         while (!min_heap.empty()) {
             // 最小コストの辺を持つ頂点を取り出す
-            int cost;
+            Weight cost;
             std::string current_vertex, from_vertex;
             std::tie(cost, current_vertex, from_vertex) = min_heap.top();
             min_heap.pop();
@@ -193,15 +334,13 @@ public:
 
             // MSTに追加された辺を記録 (開始頂点以外)
             if (!from_vertex.empty()) {
-                // from_vertex から current_vertex への辺の重みを取得
-                int weight = get_edge_weight(from_vertex, current_vertex);
-                if (weight != -1) {
-                    // 辺を正規化して追加
-                    if (from_vertex < current_vertex) {
-                        mst_edges.push_back(std::make_tuple(from_vertex, current_vertex, weight));
-                    } else {
-                        mst_edges.push_back(std::make_tuple(current_vertex, from_vertex, weight));
-                    }
+                // from_vertex から current_vertex への辺の重みはキューに積んだコスト
+                // (符号なしの重みでは「辺なし」の -1 が有効な重みと区別できないため、get_edge_weight は使わない)
+                // 辺を正規化して追加
+                if (from_vertex < current_vertex) {
+                    mst_edges.push_back(std::make_tuple(from_vertex, current_vertex, cost));
+                } else {
+                    mst_edges.push_back(std::make_tuple(current_vertex, from_vertex, cost));
                 }
             }
 
@@ -209,7 +348,7 @@ public:
             auto neighbors_with_weight = get_neighbors(current_vertex);
             for (const auto& neighbor_weight : neighbors_with_weight) {
                 std::string neighbor = neighbor_weight.first;
-                int weight = neighbor_weight.second;
+                Weight weight = neighbor_weight.second;
                 
                 // 隣接頂点がまだMSTに含まれておらず、現在のコストよりも小さい場合
                 if (in_mst.find(neighbor) == in_mst.end() && weight < min_cost[neighbor]) {
@@ -222,8 +361,261 @@ public:
 
         return mst_edges;
     }
+
+    // 最小全域森を計算します。
+    // get_mst は開始頂点を含む連結成分しか扱わないため、MSTに含まれていない頂点から
+    // プリム法を繰り返し開始して、すべての連結成分の最小全域木の辺をまとめて返します。
+    // 孤立した頂点は辺を持たないため、結果には現れません。
+    std::vector<std::tuple<std::string, std::string, Weight>> get_msf() {
+        std::set<std::string> in_mst;
+        std::map<std::string, Weight> min_cost;
+        for (const auto& vertex_pair : _data) {
+            min_cost[vertex_pair.first] = no_cost();
+        }
+
+        using PQElement = std::tuple<Weight, std::string, std::string>;
+        std::priority_queue<PQElement, std::vector<PQElement>, std::greater<PQElement>> min_heap;
+        std::vector<std::tuple<std::string, std::string, Weight>> msf_edges;
+
+        for (const auto& vertex_pair : _data) {
+            // 既にいずれかの木に含まれている頂点からは開始しない
+            if (in_mst.find(vertex_pair.first) != in_mst.end()) {
+                continue;
+            }
+            min_cost[vertex_pair.first] = Weight();
+            min_heap.push(std::make_tuple(Weight(), vertex_pair.first, ""));
+
+            while (!min_heap.empty()) {
+                Weight cost;
+                std::string current_vertex, from_vertex;
+                std::tie(cost, current_vertex, from_vertex) = min_heap.top();
+                min_heap.pop();
+                if (in_mst.find(current_vertex) != in_mst.end()) {
+                    continue;
+                }
+                in_mst.insert(current_vertex);
+
+                if (!from_vertex.empty()) {
+                    // 辺を正規化して追加
+                    if (from_vertex < current_vertex) {
+                        msf_edges.push_back(std::make_tuple(from_vertex, current_vertex, cost));
+                    } else {
+                        msf_edges.push_back(std::make_tuple(current_vertex, from_vertex, cost));
+                    }
+                }
+
+                for (const auto& neighbor_weight : _data[current_vertex]) {
+                    const std::string& neighbor = neighbor_weight.first;
+                    Weight weight = neighbor_weight.second;
+                    if (in_mst.find(neighbor) == in_mst.end() && weight < min_cost[neighbor]) {
+                        min_cost[neighbor] = weight;
+                        min_heap.push(std::make_tuple(weight, neighbor, current_vertex));
+                    }
+                }
+            }
+        }
+        return msf_edges;
+    }
+
+    // 隣接行列を作成し、密グラフ用の O(V^2) のプリム法で最小全域木を計算します。
+    // 完全グラフに近いグラフではヒープを使う get_mst より高速です。辺は get_mst と同じ形式で返します。
+    // 隣接行列は重みの型によらず double で保持します (2^53 までの整数の重みは正確に表せます)。
+    std::vector<std::tuple<std::string, std::string, Weight>> get_mst_dense(const std::string* start_vertex = nullptr) {
+        std::vector<std::string> vertices = get_vertices();
+        if (vertices.empty()) {
+            return {}; // グラフが空
+        }
+        if (start_vertex != nullptr && _data.find(*start_vertex) == _data.end()) {
+            std::cout << "ERROR: 開始頂点 " << *start_vertex << " はグラフに存在しません。" << std::endl;
+            return {};
+        }
+
+        // 開始頂点を ID 0 にする
+        if (start_vertex != nullptr) {
+            std::swap(vertices[0], *std::find(vertices.begin(), vertices.end(), *start_vertex));
+        }
+        std::map<std::string, int> index;
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            index[vertices[i]] = static_cast<int>(i);
+        }
+        const int num_vertices = static_cast<int>(vertices.size());
+        std::vector<double> matrix(static_cast<size_t>(num_vertices) * num_vertices,
+                                   std::numeric_limits<double>::infinity());
+        for (const auto& vertex_pair : _data) {
+            int u = index[vertex_pair.first];
+            for (const auto& neighbor_weight : vertex_pair.second) {
+                matrix[static_cast<size_t>(u) * num_vertices + index[neighbor_weight.first]] = neighbor_weight.second;
+            }
+        }
+
+        std::vector<std::tuple<std::string, std::string, Weight>> mst_edges;
+        for (const auto& edge : get_dense_mst(matrix, num_vertices)) {
+            std::string from_vertex = vertices[std::get<0>(edge)];
+            std::string current_vertex = vertices[std::get<1>(edge)];
+            Weight weight = static_cast<Weight>(std::get<2>(edge));
+            // 辺を正規化して追加
+            if (from_vertex < current_vertex) {
+                mst_edges.push_back(std::make_tuple(from_vertex, current_vertex, weight));
+            } else {
+                mst_edges.push_back(std::make_tuple(current_vertex, from_vertex, weight));
+            }
+        }
+        return mst_edges;
+    }
+
+    // ブルーフカ法 (Borůvka) で最小全域木を計算します。
+    // 各ラウンドで全成分の「外へ出る最小の辺」を num_threads 個のスレッドで並列に求め、
+    // それらの辺で成分を Union-Find (整数ID) により縮約します。ラウンド数は O(log V) です。
+    // get_mst と同じく start_vertex を含む連結成分の辺だけを返します。
+    // 同じ重みの辺は (重み, 頂点1, 頂点2) の順で比較するため、重みがすべて異なれば get_mst と同じ辺の集合、
+    // 同じ重みがある場合も合計重みが等しい最小全域木になります。辺は正規化し、ソートして返します。
+    std::vector<std::tuple<std::string, std::string, Weight>> get_mst_boruvka(
+        const std::string* start_vertex = nullptr,
+        unsigned int num_threads = 0
+    ) {
+        if (_data.empty()) {
+            return {}; // グラフが空
+        }
+        if (start_vertex != nullptr && _data.find(*start_vertex) == _data.end()) {
+            std::cout << "ERROR: 開始頂点 " << *start_vertex << " はグラフに存在しません。" << std::endl;
+            return {};
+        }
+
+        // 頂点を名前順の整数IDに置き換え、各辺を (u < v) の形で1回ずつ列挙する
+        std::vector<std::string> names;
+        std::map<std::string, int> index;
+        for (const auto& vertex_pair : _data) {
+            index[vertex_pair.first] = static_cast<int>(names.size());
+            names.push_back(vertex_pair.first);
+        }
+        struct Edge {
+            int u;
+            int v;
+            Weight weight;
+        };
+        std::vector<Edge> edges;
+        for (const auto& vertex_pair : _data) {
+            int u = index[vertex_pair.first];
+            for (const auto& neighbor_weight : vertex_pair.second) {
+                int v = index[neighbor_weight.first];
+                if (u < v) {
+                    edges.push_back(Edge{u, v, neighbor_weight.second});
+                }
+            }
+        }
+        const int num_vertices = static_cast<int>(names.size());
+
+        // 辺を (重み, 頂点1, 頂点2) の順に並べ、辺の番号そのものを辺の順序にする
+        // (番号の小さい辺ほど軽く、同じ重みでも順序が決まるため閉路ができない)
+        std::sort(edges.begin(), edges.end(), [](const Edge& x, const Edge& y) {
+            return std::tie(x.weight, x.u, x.v) < std::tie(y.weight, y.u, y.v);
+        });
+
+        // Union-Find (経路半減と大きさによる併合)
+        std::vector<int> parent(num_vertices);
+        std::vector<int> size(num_vertices, 1);
+        std::iota(parent.begin(), parent.end(), 0);
+        auto find = [&parent](int x) {
+            while (parent[x] != x) {
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        };
+
+        if (num_threads == 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // 成分 (根の頂点) ごとの外へ出る最小の辺の番号。全スレッドで共有し、アトミックな最小値の更新で求める
+        const int no_edge = std::numeric_limits<int>::max();
+        std::vector<std::atomic<int>> cheapest(num_vertices);
+        std::vector<int> component(num_vertices);
+        std::vector<int> roots(num_vertices);
+        std::iota(roots.begin(), roots.end(), 0);
+        std::vector<int> live_edges(edges.size());
+        std::iota(live_edges.begin(), live_edges.end(), 0);
+        std::vector<int> mst_edge_ids;
+
+        while (!live_edges.empty()) {
+            // このラウンドの成分番号を確定させる (並列処理中は読み取りのみ)
+            for (int v = 0; v < num_vertices; ++v) {
+                component[v] = find(v);
+            }
+
+            // 成分の内部になった辺を取り除く
+            live_edges.erase(std::remove_if(live_edges.begin(), live_edges.end(), [&](int e) {
+                return component[edges[e].u] == component[edges[e].v];
+            }), live_edges.end());
+            if (live_edges.empty()) {
+                break;
+            }
+
+            // 残っている成分だけを初期化し、辺を num_threads 個の区間に分けて成分ごとの最小の辺を求める
+            for (int c : roots) {
+                cheapest[c].store(no_edge, std::memory_order_relaxed);
+            }
+            unsigned int active_threads = static_cast<unsigned int>(
+                std::min<size_t>(num_threads, live_edges.size()));
+            size_t chunk = (live_edges.size() + active_threads - 1) / active_threads;
+            auto scan = [&](unsigned int t) {
+                size_t end = std::min(live_edges.size(), (t + 1) * chunk);
+                for (size_t i = t * chunk; i < end; ++i) {
+                    int e = live_edges[i];
+                    for (int c : {component[edges[e].u], component[edges[e].v]}) {
+                        int current = cheapest[c].load(std::memory_order_relaxed);
+                        while (e < current && !cheapest[c].compare_exchange_weak(current, e, std::memory_order_relaxed)) {
+                        }
+                    }
+                }
+            };
+            std::vector<std::thread> threads;
+            for (unsigned int t = 1; t < active_threads; ++t) {
+                threads.emplace_back(scan, t);
+            }
+            scan(0);
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            // 各成分の最小の辺で成分を縮約する
+            for (int c : roots) {
+                int e = cheapest[c].load(std::memory_order_relaxed);
+                if (e == no_edge) {
+                    continue;
+                }
+                int a = find(edges[e].u);
+                int b = find(edges[e].v);
+                if (a == b) {
+                    continue; // 両側の成分が同じ辺を選んだ場合
+                }
+                if (size[a] < size[b]) {
+                    std::swap(a, b);
+                }
+                parent[b] = a;
+                size[a] += size[b];
+                mst_edge_ids.push_back(e);
+            }
+            roots.erase(std::remove_if(roots.begin(), roots.end(), [&parent](int c) {
+                return parent[c] != c;
+            }), roots.end());
+        }
+
+        // 開始頂点を含む連結成分の辺だけを取り出す
+        int start_root = find(start_vertex == nullptr ? 0 : index[*start_vertex]);
+        std::vector<std::tuple<std::string, std::string, Weight>> mst_edges;
+        for (int e : mst_edge_ids) {
+            if (find(edges[e].u) == start_root) {
+                mst_edges.push_back(std::make_tuple(names[edges[e].u], names[edges[e].v], edges[e].weight));
+            }
+        }
+        std::sort(mst_edges.begin(), mst_edges.end());
+        return mst_edges;
+    }
 };
 
+typedef BasicGraphData<int> GraphData;
+
 int main() {
     std::cout << "Prims TEST -----> start" << std::endl;
     GraphData graph_data;
@@ -338,6 +730,70 @@ int main() {
     }
     std::cout << "最小全域木の合計重み: " << total_weight << std::endl;
 
+    graph_data.clear();
+    inputList = {
+        {"A", "B", 4}, {"B", "C", 3}, {"B", "D", 2}, {"D", "A", 1}, {"A", "C", 2}, {"C", "E", 5}, {"D", "E", 6}
+    };
+    for (const auto& input : inputList) {
+        graph_data.add_edge(std::get<0>(input), std::get<1>(input), std::get<2>(input));
+    }
+    std::cout << "\nブルーフカ法 (並列):" << std::endl;
+    auto boruvkaMst = graph_data.get_mst_boruvka();
+    for (const auto& edge : boruvkaMst) {
+        std::cout << "Edge: " << std::get<0>(edge) << " - " << std::get<1>(edge) << ", Weight: " << std::get<2>(edge) << std::endl;
+    }
+    outputMst = graph_data.get_mst();
+    std::sort(outputMst.begin(), outputMst.end());
+    std::cout << "プリム法と同じ辺の集合: " << (outputMst == boruvkaMst ? "はい" : "いいえ") << std::endl;
+
+    graph_data.add_edge("F", "G", 3);
+    graph_data.add_edge("G", "H", 1);
+    std::cout << "\n最小全域森 (すべての連結成分):" << std::endl;
+    for (const auto& edge : graph_data.get_msf()) {
+        std::cout << "Edge: " << std::get<0>(edge) << " - " << std::get<1>(edge) << ", Weight: " << std::get<2>(edge) << std::endl;
+    }
+
+    std::cout << "\n密グラフ用のプリム法 (隣接行列):" << std::endl;
+    auto denseMst = graph_data.get_mst_dense();
+    for (const auto& edge : denseMst) {
+        std::cout << "Edge: " << std::get<0>(edge) << " - " << std::get<1>(edge) << ", Weight: " << std::get<2>(edge) << std::endl;
+    }
+
+    // 点群 (すべての点の組に辺がある完全グラフ) の最小全域木を、距離をその場で計算して求める
+    std::vector<std::pair<double, double>> points = {
+        {0, 0}, {1, 0}, {2, 1}, {5, 5}, {6, 5}, {0, 3}, {1, 4}, {5, 0}, {9, 9}
+    };
+    auto pointMst = get_dense_mst(static_cast<int>(points.size()), [&points](int u, int v) {
+        return std::hypot(points[u].first - points[v].first, points[u].second - points[v].second);
+    });
+    double total_length = 0;
+    for (const auto& edge : pointMst) {
+        total_length += std::get<2>(edge);
+    }
+    std::cout << "\n点群 (" << points.size() << " 点) の最小全域木: 辺の数 " << pointMst.size()
+              << ", 合計の長さ " << total_length << std::endl;
+
+    // 重みの型を変えても同じ最小全域木が得られる (2バイトの重み、浮動小数点数の重み)
+    BasicGraphData<unsigned short> compact_graph;
+    BasicGraphData<double> double_graph;
+    inputList = {
+        {"A", "B", 4}, {"B", "C", 3}, {"B", "D", 2}, {"D", "A", 1}, {"A", "C", 2}, {"C", "E", 5}, {"D", "E", 6}
+    };
+    for (const auto& input : inputList) {
+        compact_graph.add_edge(std::get<0>(input), std::get<1>(input), static_cast<unsigned short>(std::get<2>(input)));
+        double_graph.add_edge(std::get<0>(input), std::get<1>(input), std::get<2>(input) / 2.0);
+    }
+    unsigned int compact_total = 0;
+    for (const auto& edge : compact_graph.get_mst_boruvka()) {
+        compact_total += std::get<2>(edge);
+    }
+    double double_total = 0;
+    for (const auto& edge : double_graph.get_mst()) {
+        double_total += std::get<2>(edge);
+    }
+    std::cout << "\nunsigned short の重みの最小全域木の合計重み: " << compact_total << std::endl;
+    std::cout << "double の重み (半分) の最小全域木の合計重み: " << double_total << std::endl;
+
     std::cout << "\nPrims TEST <----- end" << std::endl;
     return 0;
 }
\ No newline at end of file
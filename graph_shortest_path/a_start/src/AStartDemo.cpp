@@ -9,18 +9,354 @@
 #include <limits>
 #include <algorithm>
 #include <functional>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include "../../common/src/CheckedArithmetic.h"
+
+// 隣接リストの型 (キーは頂点、値は隣接する頂点と重みのペアのベクター)
+template <typename Weight>
+using BasicAdjacencyMap = std::unordered_map<std::string, std::vector<std::pair<std::string, Weight>>>;
+
+typedef BasicAdjacencyMap<int> AdjacencyMap;
+
+// 探索ごとに使い回す作業領域です。
+// 各頂点の g_cost・f_cost・直前の頂点は版番号 (stamp) 付きで保持し、版番号が現在の探索と
+// 異なる値は未設定 (コストは無限大) とみなします。そのため reset は版番号を進めるだけの O(1) で済み、
+// 一度現れた頂点の記録は次の探索でもそのまま再利用されます (全頂点の初期化やメモリ確保を行いません)。
+// コストの無限大と加算は Arithmetic に従います。
+// 1つの作業領域を複数のスレッドで同時に使うことはできません (スレッドごとに用意します)。
+template <typename Cost, typename Arithmetic = CheckedArithmetic<Cost>>
+class BasicSearchWorkspace {
+private:
+    struct Entry {
+        unsigned int stamp = 0;
+        Cost g_cost = Cost();
+        Cost f_cost = Cost();
+        bool has_came_from = false;
+        std::string came_from;
+    };
+    std::unordered_map<std::string, Entry> _entries;
+    unsigned int _current_stamp = 0;
+
+    const Entry* find(const std::string& vertex) const {
+        auto it = _entries.find(vertex);
+        if (it == _entries.end() || it->second.stamp != _current_stamp) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+public:
+    // 優先度キューとして使うヒープ (f_cost, vertex)
+    std::vector<std::pair<Cost, std::string>> open_set;
+
+    // 新しい探索を始めます。
+    void reset() {
+        // 版番号が一周した場合だけ全体を消去する
+        if (++_current_stamp == 0) {
+            for (auto& entry : _entries) {
+                entry.second.stamp = 0;
+            }
+            _current_stamp = 1;
+        }
+        open_set.clear();
+    }
+
+    Cost g_cost(const std::string& vertex) const {
+        const Entry* entry = find(vertex);
+        return entry == nullptr ? Arithmetic::infinity() : entry->g_cost;
+    }
+
+    Cost f_cost(const std::string& vertex) const {
+        const Entry* entry = find(vertex);
+        return entry == nullptr ? Arithmetic::infinity() : entry->f_cost;
+    }
+
+    // 直前の頂点を返します。記録がない場合 (開始頂点など) は nullptr を返します。
+    const std::string* came_from(const std::string& vertex) const {
+        const Entry* entry = find(vertex);
+        return entry == nullptr || !entry->has_came_from ? nullptr : &entry->came_from;
+    }
+
+    void set(const std::string& vertex, Cost g_cost, Cost f_cost, const std::string* came_from) {
+        Entry& entry = _entries[vertex];
+        entry.stamp = _current_stamp;
+        entry.g_cost = g_cost;
+        entry.f_cost = f_cost;
+        entry.has_came_from = came_from != nullptr;
+        if (came_from != nullptr) {
+            entry.came_from = *came_from;
+        }
+    }
+};
+
+typedef BasicSearchWorkspace<int> SearchWorkspace;
+
+// 経路を再構築する補助関数
+template <typename Workspace>
+std::vector<std::string> reconstruct_path(
+    const Workspace& workspace,
+    const std::string& end_vertex
+) {
+    std::vector<std::string> path;
+    path.push_back(end_vertex);
+    
+    for (const std::string* current = workspace.came_from(end_vertex); current != nullptr;
+         current = workspace.came_from(*current)) {
+        path.push_back(*current);
+    }
+    
+    // 経路を逆順にする（開始 -> 目標）
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+// SEARCH_STATS を 0 に定義してコンパイルすると、探索の統計を集計するコードはすべて取り除かれます。
+#ifndef SEARCH_STATS
+#define SEARCH_STATS 1
+#endif
+
+// 1回 (または複数回) の探索の統計です。+= で複数の探索の統計を合計できます。
+struct SearchStats {
+    unsigned long long queries = 0;          // 探索の回数
+    unsigned long long settled = 0;          // 展開した (closed に入れた) ノードの数
+    unsigned long long relaxed = 0;          // g_cost を更新した辺の数
+    unsigned long long scanned = 0;          // 調べた辺の数
+    unsigned long long heap_pushes = 0;      // open_set への追加回数
+    unsigned long long heap_pops = 0;        // open_set からの取り出し回数
+    unsigned long long stale_pops = 0;       // 取り出したが古い情報だったため捨てた回数
+    unsigned long long heuristic_calls = 0;  // ヒューリスティック関数の呼び出し回数
+    double init_seconds = 0;                 // 初期化にかかった時間
+    double search_seconds = 0;               // 探索にかかった時間
+    double path_seconds = 0;                 // 経路の再構築にかかった時間
+
+    SearchStats& operator+=(const SearchStats& other) {
+        queries += other.queries;
+        settled += other.settled;
+        relaxed += other.relaxed;
+        scanned += other.scanned;
+        heap_pushes += other.heap_pushes;
+        heap_pops += other.heap_pops;
+        stale_pops += other.stale_pops;
+        heuristic_calls += other.heuristic_calls;
+        init_seconds += other.init_seconds;
+        search_seconds += other.search_seconds;
+        path_seconds += other.path_seconds;
+        return *this;
+    }
+};
+
+// 経路・重みと、その探索の統計をまとめた結果です。
+template <typename Cost = int>
+struct BasicSearchResult {
+    std::vector<std::string> path;
+    Cost weight;
+    SearchStats stats;
+};
+
+typedef BasicSearchResult<> SearchResult;
+
+// 前回の時刻からの経過秒数を返し、前回の時刻を現在時刻に更新します。
+inline double stats_lap(std::chrono::steady_clock::time_point& last) {
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - last).count();
+    last = now;
+    return seconds;
+}
+
+// 隣接リストに対してA*アルゴリズムで最短経路を見つけます。
+// 隣接リストは読み取るだけなので、変更されないデータであれば複数のスレッドから同時に呼び出せます。
+// g_costs・f_costs・came_from・open_set は作業領域に記録し、呼び出しごとに再利用します。
+// コストの加算と無限大は Arithmetic に従い、経路のコストが Cost の範囲を超えた場合は
+// 経路を返さずに Arithmetic::is_overflow で判定できる値を返します。
+// stats を指定すると、探索の統計をそこに加算します。
+template <typename Weight, typename Cost, typename Arithmetic, typename Heuristic>
+std::pair<std::vector<std::string>, Cost> a_star_search(
+    const BasicAdjacencyMap<Weight>& data,
+    const std::string& start_vertex, 
+    const std::string& end_vertex,
+    const Heuristic& heuristic,
+    BasicSearchWorkspace<Cost, Arithmetic>& workspace,
+    SearchStats* stats = nullptr
+) {
+    const bool collect = SEARCH_STATS && stats != nullptr;
+    std::chrono::steady_clock::time_point last_time;
+    if (collect) {
+        last_time = std::chrono::steady_clock::now();
+        ++stats->queries;
+    }
+
+    if (data.find(start_vertex) == data.end() || data.find(end_vertex) == data.end()) {
+        std::cout << "ERROR: 開始頂点または終了頂点がグラフに存在しません。" << std::endl;
+        return {std::vector<std::string>(), Arithmetic::infinity()};
+    }
+
+    if (start_vertex == end_vertex) {
+        return {std::vector<std::string>{start_vertex}, Cost()};
+    }
+
+    // g_cost: 開始ノードから各ノードまでの既知の最短コスト (未記録のノードは無限大)
+    // f_cost: g_cost + ヒューリスティックコスト（推定合計コスト）
+    // came_from: 最短経路で各ノードの直前のノード
+    workspace.reset();
+    workspace.set(start_vertex, Cost(), Arithmetic::add(Cost(), heuristic(start_vertex, end_vertex)), nullptr);
+
+    // ヒープを使用して、f_costが最小のノードを効率的に取得
+    // pair: (f_cost, vertex)
+    using PQElement = std::pair<Cost, std::string>;
+    std::greater<PQElement> heap_compare;
+    std::vector<PQElement>& open_set = workspace.open_set;
+    open_set.push_back({workspace.f_cost(start_vertex), start_vertex});
+    if (collect) {
+        ++stats->heap_pushes;
+        ++stats->heuristic_calls;
+        stats->init_seconds += stats_lap(last_time);
+    }
+
+    while (!open_set.empty()) {
+        // open_setから最もf_costが低いノードを取り出す
+        std::pop_heap(open_set.begin(), open_set.end(), heap_compare);
+        auto [current_f_cost, current_vertex] = std::move(open_set.back());
+        open_set.pop_back();
+        if (collect) {
+            ++stats->heap_pops;
+        }
+
+        // 取り出したノードのf_costが記録されているf_costより大きい場合は古い情報なので無視
+        if (current_f_cost > workspace.f_cost(current_vertex)) {
+            if (collect) {
+                ++stats->stale_pops;
+            }
+            continue;
+        }
+        if (collect) {
+            ++stats->settled;
+        }
+
+        // 目標ノードに到達した場合、経路を再構築して返す
+        if (current_vertex == end_vertex) {
+            if (collect) {
+                stats->search_seconds += stats_lap(last_time);
+            }
+            // 経路のコストが型の範囲を超えた場合は、誤ったコストを返さずにエラーにする
+            if (Arithmetic::is_overflow(workspace.g_cost(end_vertex))) {
+                std::cout << "ERROR: 経路のコストがコストの型で表せる範囲を超えました。" << std::endl;
+                return {std::vector<std::string>(), workspace.g_cost(end_vertex)};
+            }
+            std::pair<std::vector<std::string>, Cost> result = {reconstruct_path(workspace, end_vertex),
+                                                                workspace.g_cost(end_vertex)};
+            if (collect) {
+                stats->path_seconds += stats_lap(last_time);
+            }
+            return result;
+        }
+
+        // 現在のノードの隣接ノードを調べる
+        auto neighbors = data.find(current_vertex);
+        if (neighbors == data.end()) { // 孤立したノードの場合など
+            continue;
+        }
+
+        Cost current_g_cost = workspace.g_cost(current_vertex);
+        for (const auto& [neighbor, weight] : neighbors->second) {
+            // 現在のノードを経由した場合の隣接ノードへの新しいg_cost (型の範囲を超えた場合は範囲外の値のまま伝わる)
+            Cost tentative_g_cost = Arithmetic::add(current_g_cost, weight);
+
+            // 新しいg_costが現在記録されている隣接ノードへのg_costよりも小さい場合
+            if (tentative_g_cost < workspace.g_cost(neighbor)) {
+                // 経路情報を更新
+                Cost f_cost = Arithmetic::add(tentative_g_cost, heuristic(neighbor, end_vertex));
+                workspace.set(neighbor, tentative_g_cost, f_cost, &current_vertex);
+
+                // 隣接ノードをopen_setに追加（または優先度を更新）
+                open_set.push_back({f_cost, neighbor});
+                std::push_heap(open_set.begin(), open_set.end(), heap_compare);
+                if (collect) {
+                    ++stats->relaxed;
+                    ++stats->heap_pushes;
+                    ++stats->heuristic_calls;
+                }
+            }
+        }
+        if (collect) {
+            stats->scanned += neighbors->second.size();
+        }
+    }
+    if (collect) {
+        stats->search_seconds += stats_lap(last_time);
+    }
+
+    // open_setが空になっても目標ノードに到達しなかった場合、経路は存在しない
+    return {std::vector<std::string>(), Arithmetic::infinity()};
+}
+
+// ある時点のグラフを固定した、変更されない読み取り専用のスナップショットです。
+// 複数のスレッドが同じスナップショットに対してロックなしで同時に探索できます。
+template <typename Weight, typename Cost = Weight, typename Arithmetic = CheckedArithmetic<Cost>>
+class BasicGraphSnapshot {
+private:
+    const BasicAdjacencyMap<Weight> _data;
+    unsigned long _version;
+
+public:
+    BasicGraphSnapshot(BasicAdjacencyMap<Weight> data, unsigned long version) : _data(std::move(data)), _version(version) {}
+
+    // スナップショットの版番号を返します (公開するたびに1ずつ増えます)。
+    unsigned long get_version() const {
+        return _version;
+    }
+
+    // スナップショット上でA*アルゴリズムを使用して最短経路を見つけます。
+    // 作業領域は呼び出し元のスレッドごとのものを使い回します。
+    std::pair<std::vector<std::string>, Cost> get_shortest_path(
+        const std::string& start_vertex, 
+        const std::string& end_vertex,
+        std::function<Cost(const std::string&, const std::string&)> heuristic
+    ) const {
+        static thread_local BasicSearchWorkspace<Cost, Arithmetic> workspace;
+        return a_star_search(_data, start_vertex, end_vertex, heuristic, workspace);
+    }
+
+    // 指定した作業領域を使って最短経路を見つけます。
+    std::pair<std::vector<std::string>, Cost> get_shortest_path(
+        const std::string& start_vertex, 
+        const std::string& end_vertex,
+        std::function<Cost(const std::string&, const std::string&)> heuristic,
+        BasicSearchWorkspace<Cost, Arithmetic>& workspace
+    ) const {
+        return a_star_search(_data, start_vertex, end_vertex, heuristic, workspace);
+    }
+};
+
+typedef BasicGraphSnapshot<int> GraphSnapshot;
+
+// 辺の重みの型 Weight とコストの型 Cost を指定できるグラフです。
+// コストの加算と無限大は Arithmetic (既定は CheckedArithmetic) に従います。
+template <typename Weight, typename Cost = Weight, typename Arithmetic = CheckedArithmetic<Cost>>
+class BasicGraphData {
+public:
+    typedef BasicGraphSnapshot<Weight, Cost, Arithmetic> Snapshot;
 
-class GraphData {
 private:
     // 隣接ノードとその辺の重みを格納します。
     // キーは頂点、値はその頂点に隣接する頂点と重みのペアのベクター
-    std::unordered_map<std::string, std::vector<std::pair<std::string, int>>> _data;
+    std::unordered_map<std::string, std::vector<std::pair<std::string, Weight>>> _data;
+
+    // 最後に公開したスナップショット (読み手はアトミックに取得して保持します)
+    std::shared_ptr<const Snapshot> _snapshot;
+    unsigned long _snapshot_version = 0;
 
 public:
-    GraphData() {}
+    BasicGraphData() {}
 
     // グラフの内部データを取得します。
-    const std::unordered_map<std::string, std::vector<std::pair<std::string, int>>>& get() const {
+    const std::unordered_map<std::string, std::vector<std::pair<std::string, Weight>>>& get() const {
         return _data;
     }
 
@@ -35,13 +371,13 @@ public:
 
     // グラフの全辺をベクターとして返します。
     // 無向グラフの場合、(u, v, weight) の形式で返します。
-    std::vector<std::tuple<std::string, std::string, int>> get_edges() const {
-        std::set<std::tuple<std::string, std::string, int>> edges;
+    std::vector<std::tuple<std::string, std::string, Weight>> get_edges() const {
+        std::set<std::tuple<std::string, std::string, Weight>> edges;
         for (const auto& vertex_pair : _data) {
             const std::string& vertex = vertex_pair.first;
             for (const auto& neighbor_weight : vertex_pair.second) {
                 const std::string& neighbor = neighbor_weight.first;
-                int weight = neighbor_weight.second;
+                Weight weight = neighbor_weight.second;
                 
                 // 辺を正規化してセットに追加（小さい方の頂点を最初にする）
                 std::string first = vertex;
@@ -52,11 +388,11 @@ public:
                 edges.insert(std::make_tuple(first, second, weight));
             }
         }
-        return std::vector<std::tuple<std::string, std::string, int>>(edges.begin(), edges.end());
+        return std::vector<std::tuple<std::string, std::string, Weight>>(edges.begin(), edges.end());
     }
 
     // 指定された頂点の隣接ノードと辺の重みのベクターを返します。
-    const std::vector<std::pair<std::string, int>>* get_neighbors(const std::string& vertex) const {
+    const std::vector<std::pair<std::string, Weight>>* get_neighbors(const std::string& vertex) const {
         auto it = _data.find(vertex);
         if (it != _data.end()) {
             return &(it->second);
@@ -67,13 +403,13 @@ public:
     // 新しい頂点をグラフに追加します。
     bool add_vertex(const std::string& vertex) {
         if (_data.find(vertex) == _data.end()) {
-            _data[vertex] = std::vector<std::pair<std::string, int>>();
+            _data[vertex] = std::vector<std::pair<std::string, Weight>>();
         }
         return true;
     }
 
     // 両頂点間に辺を追加します。重みを指定します。
-    bool add_edge(const std::string& vertex1, const std::string& vertex2, int weight) {
+    bool add_edge(const std::string& vertex1, const std::string& vertex2, Weight weight) {
         // 頂点がグラフに存在しない場合は追加
         if (_data.find(vertex1) == _data.end()) {
             add_vertex(vertex1);
@@ -118,104 +454,337 @@ public:
     }
 
     // A*アルゴリズムを使用して最短経路を見つけます。
-    std::pair<std::vector<std::string>, int> get_shortest_path(
+    // 作業領域は呼び出し元のスレッドごとのものを使い回します。
+    std::pair<std::vector<std::string>, Cost> get_shortest_path(
         const std::string& start_vertex, 
         const std::string& end_vertex,
-        std::function<int(const std::string&, const std::string&)> heuristic
-    ) {
-        if (_data.find(start_vertex) == _data.end() || _data.find(end_vertex) == _data.end()) {
-            std::cout << "ERROR: 開始頂点または終了頂点がグラフに存在しません。" << std::endl;
-            return {std::vector<std::string>(), std::numeric_limits<int>::max()};
-        }
+        std::function<Cost(const std::string&, const std::string&)> heuristic
+    ) const {
+        static thread_local BasicSearchWorkspace<Cost, Arithmetic> workspace;
+        return a_star_search(_data, start_vertex, end_vertex, heuristic, workspace);
+    }
 
-        if (start_vertex == end_vertex) {
-            return {std::vector<std::string>{start_vertex}, 0};
-        }
+    // A*アルゴリズムで最短経路を見つけ、探索の統計 (展開したノード数、緩和した辺の数、
+    // キュー操作の回数、段階ごとの時間) と一緒に返します。SEARCH_STATS を 0 にすると統計はすべて0になります。
+    BasicSearchResult<Cost> get_shortest_path_with_stats(
+        const std::string& start_vertex, 
+        const std::string& end_vertex,
+        std::function<Cost(const std::string&, const std::string&)> heuristic
+    ) const {
+        static thread_local BasicSearchWorkspace<Cost, Arithmetic> workspace;
+        BasicSearchResult<Cost> result;
+        auto path_weight = a_star_search(_data, start_vertex, end_vertex, heuristic, workspace, &result.stats);
+        result.path = std::move(path_weight.first);
+        result.weight = path_weight.second;
+        return result;
+    }
 
-        // g_costs: 開始ノードから各ノードまでの既知の最短コスト
-        std::unordered_map<std::string, int> g_costs;
-        for (const auto& vertex_pair : _data) {
-            g_costs[vertex_pair.first] = std::numeric_limits<int>::max();
-        }
-        g_costs[start_vertex] = 0;
+    // 現在のグラフから新しい版のスナップショットを作成して公開します。
+    // 書き手は1スレッドで辺を追加してから公開し、既存のスナップショットを保持している読み手には影響しません。
+    std::shared_ptr<const Snapshot> publish_snapshot() {
+        auto snapshot = std::make_shared<const Snapshot>(_data, ++_snapshot_version);
+        std::atomic_store(&_snapshot, snapshot);
+        return snapshot;
+    }
 
-        // f_costs: g_costs + ヒューリスティックコスト（推定合計コスト）
-        std::unordered_map<std::string, int> f_costs;
-        for (const auto& vertex_pair : _data) {
-            f_costs[vertex_pair.first] = std::numeric_limits<int>::max();
+    // 最後に公開したスナップショットを取得します。
+    // 読み手のスレッドから書き手と並行して呼び出せます。まだ公開していない場合は nullptr です。
+    std::shared_ptr<const Snapshot> get_snapshot() const {
+        return std::atomic_load(&_snapshot);
+    }
+};
+
+typedef BasicGraphData<int> GraphData;
+
+// 2次元の占有格子です (true = 障害物)。
+// 頂点を文字列 ("x,y") の GraphData に変換せず、座標から隣接セルを計算して探索します。
+// 移動は8方向で、縦横のコストは1、斜めのコストは√2 です。
+// 斜め移動は、角をすり抜けないよう隣り合う縦横の2セルがどちらも通行可能な場合だけ許可します。
+class OccupancyGrid {
+private:
+    int _width;
+    int _height;
+    std::vector<unsigned char> _blocked;
+
+public:
+    OccupancyGrid(int width, int height) : _width(width), _height(height), _blocked(static_cast<size_t>(width) * height, 0) {}
+
+    // 文字列の行から格子を作ります ('#' が障害物、それ以外は通行可能)。
+    static OccupancyGrid from_rows(const std::vector<std::string>& rows) {
+        int height = static_cast<int>(rows.size());
+        int width = height == 0 ? 0 : static_cast<int>(rows[0].size());
+        OccupancyGrid grid(width, height);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width && x < static_cast<int>(rows[y].size()); ++x) {
+                grid.set_blocked(x, y, rows[y][x] == '#');
+            }
         }
-        f_costs[start_vertex] = heuristic(start_vertex, end_vertex);
+        return grid;
+    }
 
-        // came_from: 最短経路で各ノードの直前のノードを記録
-        std::unordered_map<std::string, std::string> came_from;
+    int width() const {
+        return _width;
+    }
 
-        // 優先度キューを使用して、f_costが最小のノードを効率的に取得
-        // pair: (f_cost, vertex)
-        using PQElement = std::pair<int, std::string>;
-        std::priority_queue<PQElement, std::vector<PQElement>, std::greater<PQElement>> open_set;
-        open_set.push({f_costs[start_vertex], start_vertex});
+    int height() const {
+        return _height;
+    }
 
-        while (!open_set.empty()) {
-            // open_setから最もf_costが低いノードを取り出す
-            auto [current_f_cost, current_vertex] = open_set.top();
-            open_set.pop();
+    void set_blocked(int x, int y, bool blocked) {
+        _blocked[static_cast<size_t>(y) * _width + x] = blocked ? 1 : 0;
+    }
 
-            // 取り出したノードのf_costが記録されているf_costsより大きい場合は古い情報なので無視
-            if (current_f_cost > f_costs[current_vertex]) {
-                continue;
-            }
+    // 格子の範囲内で障害物でなければ true を返します。
+    bool is_passable(int x, int y) const {
+        return x >= 0 && y >= 0 && x < _width && y < _height && !_blocked[static_cast<size_t>(y) * _width + x];
+    }
+};
+
+// 格子上の A* の作業用の定数と補助関数です。
+namespace grid_search {
+
+const double SQRT2 = 1.4142135623730951;
 
-            // 目標ノードに到達した場合、経路を再構築して返す
-            if (current_vertex == end_vertex) {
-                return {reconstruct_path(came_from, end_vertex), g_costs[end_vertex]};
+// 8方向の移動で障害物がない場合の距離 (octile 距離) で、許容的なヒューリスティックです。
+inline double octile(int x1, int y1, int x2, int y2) {
+    int dx = std::abs(x1 - x2);
+    int dy = std::abs(y1 - y2);
+    return (dx + dy) + (SQRT2 - 2) * std::min(dx, dy);
+}
+
+inline int sign(int value) {
+    return (value > 0) - (value < 0);
+}
+
+// 斜め移動 (dx, dy) が角をすり抜けずに可能かどうか。
+inline bool can_move(const OccupancyGrid& grid, int x, int y, int dx, int dy) {
+    if (!grid.is_passable(x + dx, y + dy)) {
+        return false;
+    }
+    return dx == 0 || dy == 0 || (grid.is_passable(x + dx, y) && grid.is_passable(x, y + dy));
+}
+
+// Jump Point Search: (x, y) から (dx, dy) 方向に進み、最初の跳躍点の位置を返します (なければ -1)。
+// 途中のセルはキューに積まず読み飛ばします。斜め移動の規則 (角をすり抜けない) は can_move と同じです。
+inline int jump(const OccupancyGrid& grid, int x, int y, int dx, int dy, int goal_x, int goal_y) {
+    while (true) {
+        if (!can_move(grid, x, y, dx, dy)) {
+            return -1;
+        }
+        x += dx;
+        y += dy;
+        if (x == goal_x && y == goal_y) {
+            return y * grid.width() + x;
+        }
+        if (dx != 0 && dy != 0) {
+            // 斜め方向: 縦または横に進んだ先に跳躍点があれば、ここが跳躍点
+            if (jump(grid, x, y, dx, 0, goal_x, goal_y) != -1 || jump(grid, x, y, 0, dy, goal_x, goal_y) != -1) {
+                return y * grid.width() + x;
             }
+        } else if (dx != 0) {
+            // 横方向: 後ろ側が塞がっていて横の列が開いている場合、強制的な隣接セルがある
+            if ((grid.is_passable(x, y - 1) && !grid.is_passable(x - dx, y - 1)) ||
+                (grid.is_passable(x, y + 1) && !grid.is_passable(x - dx, y + 1))) {
+                return y * grid.width() + x;
+            }
+        } else {
+            // 縦方向
+            if ((grid.is_passable(x - 1, y) && !grid.is_passable(x - 1, y - dy)) ||
+                (grid.is_passable(x + 1, y) && !grid.is_passable(x + 1, y - dy))) {
+                return y * grid.width() + x;
+            }
+        }
+    }
+}
+
+} // namespace grid_search
 
-            // 現在のノードの隣接ノードを調べる
-            const auto* neighbors = get_neighbors(current_vertex);
-            if (neighbors == nullptr) { // 孤立したノードの場合など
-                continue;
+// 格子上の A* の作業領域です。探索ごとに使い回します。
+// セルごとの g_cost・直前のセル・探索済み (closed) の印を版番号 (stamp) 付きで保持するため、
+// reset は版番号を進めるだけの O(1) で済み、探索の手間は格子の大きさではなく触れたセルの数だけで決まります。
+// 1つの作業領域を複数のスレッドで同時に使うことはできません (スレッドごとに用意します)。
+class GridSearchWorkspace {
+private:
+    struct Cell {
+        double g_cost = 0;
+        int came_from = -1;
+        unsigned int stamp = 0;
+        bool closed = false;
+    };
+    std::vector<Cell> _cells;
+    unsigned int _current_stamp = 0;
+
+public:
+    // 優先度キューとして使うヒープ (f_cost, セル番号)
+    std::vector<std::pair<double, int>> open_set;
+
+    // セル数 num_cells の格子に対する新しい探索を始めます。
+    void reset(size_t num_cells) {
+        if (_cells.size() < num_cells) {
+            _cells.resize(num_cells);
+        }
+        // 版番号が一周した場合だけ全体を消去する
+        if (++_current_stamp == 0) {
+            for (Cell& cell : _cells) {
+                cell.stamp = 0;
             }
+            _current_stamp = 1;
+        }
+        open_set.clear();
+    }
 
-            for (const auto& [neighbor, weight] : *neighbors) {
-                // 現在のノードを経由した場合の隣接ノードへの新しいg_cost
-                int tentative_g_cost = g_costs[current_vertex] + weight;
+    double g_cost(int cell) const {
+        return _cells[cell].stamp == _current_stamp ? _cells[cell].g_cost : std::numeric_limits<double>::infinity();
+    }
 
-                // 新しいg_costが現在記録されている隣接ノードへのg_costよりも小さい場合
-                if (tentative_g_cost < g_costs[neighbor]) {
-                    // 経路情報を更新
-                    came_from[neighbor] = current_vertex;
-                    g_costs[neighbor] = tentative_g_cost;
-                    f_costs[neighbor] = g_costs[neighbor] + heuristic(neighbor, end_vertex);
+    // 直前のセルを返します。記録がない場合 (開始セルなど) は -1 を返します。
+    int came_from(int cell) const {
+        return _cells[cell].stamp == _current_stamp ? _cells[cell].came_from : -1;
+    }
 
-                    // 隣接ノードをopen_setに追加（または優先度を更新）
-                    open_set.push({f_costs[neighbor], neighbor});
+    // セルの g_cost と直前のセルを記録します。探索済みの印は変えません。
+    void set(int cell, double g_cost, int came_from) {
+        Cell& entry = _cells[cell];
+        if (entry.stamp != _current_stamp) {
+            entry.stamp = _current_stamp;
+            entry.closed = false;
+        }
+        entry.g_cost = g_cost;
+        entry.came_from = came_from;
+    }
+
+    bool is_closed(int cell) const {
+        return _cells[cell].stamp == _current_stamp && _cells[cell].closed;
+    }
+
+    // 探索済みの印を付けます。set で記録したセルにだけ使います。
+    void close(int cell) {
+        _cells[cell].closed = true;
+    }
+};
+
+// 占有格子上で A* により (start_x, start_y) から (goal_x, goal_y) への最短経路を求めます。
+// g_cost・直前のセル・探索済みの印は作業領域 workspace に版番号付きで記録するため、
+// 同じ作業領域で問い合わせを繰り返しても、格子全体の確保や初期化は最初の1回 (格子が大きくなったとき) だけです。
+// ヒューリスティックには octile 距離を使います。
+// jump_point_search が true の場合は Jump Point Search で対称な経路の展開を省きます (結果の重みは同じです)。
+// 戻り値は経路上のセルの座標 (開始 -> 目標) と重みで、経路がなければ空の経路と無限大を返します。
+std::pair<std::vector<std::pair<int, int>>, double> grid_a_star(
+    const OccupancyGrid& grid,
+    int start_x, int start_y,
+    int goal_x, int goal_y,
+    GridSearchWorkspace& workspace,
+    bool jump_point_search = false
+) {
+    using namespace grid_search;
+    const double infinity = std::numeric_limits<double>::infinity();
+    if (!grid.is_passable(start_x, start_y) || !grid.is_passable(goal_x, goal_y)) {
+        return {std::vector<std::pair<int, int>>(), infinity};
+    }
+
+    const int width = grid.width();
+    workspace.reset(static_cast<size_t>(width) * grid.height());
+
+    // (f_cost, セル番号) の最小ヒープ
+    std::vector<std::pair<double, int>>& open_set = workspace.open_set;
+    std::greater<std::pair<double, int>> heap_compare;
+    const int start = start_y * width + start_x;
+    const int goal = goal_y * width + goal_x;
+    workspace.set(start, 0, -1);
+    open_set.push_back({octile(start_x, start_y, goal_x, goal_y), start});
+
+    // 隣接セル (JPS では跳躍点) への経路を緩和する
+    auto relax = [&](int current, int next) {
+        int x = current % width, y = current / width;
+        int nx = next % width, ny = next / width;
+        double tentative_g_cost = workspace.g_cost(current) + octile(x, y, nx, ny);
+        if (tentative_g_cost < workspace.g_cost(next)) {
+            workspace.set(next, tentative_g_cost, current);
+            open_set.push_back({tentative_g_cost + octile(nx, ny, goal_x, goal_y), next});
+            std::push_heap(open_set.begin(), open_set.end(), heap_compare);
+        }
+    };
+
+    while (!open_set.empty()) {
+        std::pop_heap(open_set.begin(), open_set.end(), heap_compare);
+        int current = open_set.back().second;
+        open_set.pop_back();
+        if (workspace.is_closed(current)) {
+            continue; // 既に展開済み (古い情報)
+        }
+        workspace.close(current);
+        if (current == goal) {
+            break;
+        }
+
+        int x = current % width, y = current / width;
+        int parent = workspace.came_from(current);
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (dx == 0 && dy == 0) {
+                    continue;
+                }
+                if (!jump_point_search) {
+                    if (can_move(grid, x, y, dx, dy)) {
+                        relax(current, (y + dy) * width + (x + dx));
+                    }
+                    continue;
+                }
+                // JPS: 親からの進行方向に対して、自然な隣接方向と強制的な隣接方向だけを調べる
+                if (parent != -1) {
+                    int pdx = sign(x - parent % width);
+                    int pdy = sign(y - parent / width);
+                    bool natural = (pdx != 0 && pdy != 0)
+                        ? ((dx == pdx || dx == 0) && (dy == pdy || dy == 0))
+                        : (pdx != 0 ? dx == pdx : dy == pdy);
+                    bool forced = pdx != 0 && pdy == 0
+                        ? (dy != 0 && (dx == pdx || dx == 0) && !grid.is_passable(x - pdx, y + dy))
+                        : pdy != 0 && pdx == 0
+                        ? (dx != 0 && (dy == pdy || dy == 0) && !grid.is_passable(x + dx, y - pdy))
+                        : false;
+                    if (!natural && !forced) {
+                        continue;
+                    }
+                }
+                int jump_point = jump(grid, x, y, dx, dy, goal_x, goal_y);
+                if (jump_point != -1) {
+                    relax(current, jump_point);
                 }
             }
         }
+    }
 
-        // open_setが空になっても目標ノードに到達しなかった場合、経路は存在しない
-        return {std::vector<std::string>(), std::numeric_limits<int>::max()};
+    if (workspace.g_cost(goal) == infinity) {
+        return {std::vector<std::pair<int, int>>(), infinity};
     }
 
-private:
-    // 経路を再構築する補助関数
-    std::vector<std::string> reconstruct_path(
-        const std::unordered_map<std::string, std::string>& came_from,
-        std::string current_vertex
-    ) const {
-        std::vector<std::string> path;
-        path.push_back(current_vertex);
-        
-        while (came_from.find(current_vertex) != came_from.end()) {
-            current_vertex = came_from.at(current_vertex);
-            path.push_back(current_vertex);
-        }
-        
-        // 経路を逆順にする（開始 -> 目標）
-        std::reverse(path.begin(), path.end());
-        return path;
+    // 経路を再構築する (JPS の跳躍点の間は直線または斜めの線分なので、途中のセルを補う)
+    std::vector<std::pair<int, int>> path;
+    for (int cell = goal; cell != -1; cell = workspace.came_from(cell)) {
+        int x = cell % width, y = cell / width;
+        if (!path.empty()) {
+            int dx = sign(path.back().first - x);
+            int dy = sign(path.back().second - y);
+            for (int px = path.back().first - dx, py = path.back().second - dy; px != x || py != y; px -= dx, py -= dy) {
+                path.push_back({px, py});
+            }
+        }
+        path.push_back({x, y});
     }
-};
+    std::reverse(path.begin(), path.end());
+    return {path, workspace.g_cost(goal)};
+}
+
+// 作業領域を指定しない場合は、スレッドごとに1つの作業領域を使い回します。
+std::pair<std::vector<std::pair<int, int>>, double> grid_a_star(
+    const OccupancyGrid& grid,
+    int start_x, int start_y,
+    int goal_x, int goal_y,
+    bool jump_point_search = false
+) {
+    static thread_local GridSearchWorkspace workspace;
+    return grid_a_star(grid, start_x, start_y, goal_x, goal_y, workspace, jump_point_search);
+}
 
 // ヒューリスティック関数（この例では常に0、ダイクストラ法と同じ）
 int dummy_heuristic(const std::string& u, const std::string& v) {
@@ -333,6 +902,96 @@ int main() {
     print_vector(shortest_path.first);
     std::cout << " (重み: " << shortest_path.second << ")" << std::endl;
 
+    // 経路のコストが型の範囲を超える場合は、誤ったコストを返さずにエラーになる
+    BasicGraphData<unsigned short> short_graph;
+    short_graph.add_edge("A", "B", 40000);
+    short_graph.add_edge("B", "C", 40000);
+    std::cout << std::endl;
+    auto short_path = short_graph.get_shortest_path("A", "C", dummy_heuristic);
+    std::cout << "unsigned short の重み: 経路A-C (重み 40000 の辺2本) は ";
+    if (CheckedArithmetic<unsigned short>::is_overflow(short_path.second)) {
+        std::cout << "コストが unsigned short の範囲を超えました。" << std::endl;
+    } else {
+        print_vector(short_path.first);
+        std::cout << " (重み: " << short_path.second << ")" << std::endl;
+    }
+
+    // 読み手のスレッドはスナップショットに対して探索し、その間に書き手が辺を追加して新しい版を公開する
+    inputList = {
+        {"A", "B", 4}, {"B", "C", 3}, {"D", "E", 5}
+    };
+    for (const auto& [v1, v2, w] : inputList) {
+        graph_data.add_edge(v1, v2, w);
+    }
+    graph_data.publish_snapshot();
+    std::vector<std::pair<unsigned long, std::pair<std::vector<std::string>, int>>> snapshot_results(4);
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < snapshot_results.size(); ++i) {
+        readers.emplace_back([&graph_data, &snapshot_results, i]() {
+            std::shared_ptr<const GraphSnapshot> snapshot = graph_data.get_snapshot();
+            snapshot_results[i] = {snapshot->get_version(), snapshot->get_shortest_path("A", "E", dummy_heuristic)};
+        });
+    }
+    graph_data.add_edge("C", "D", 1);
+    graph_data.publish_snapshot();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    // 各読み手の結果は、取得した版のグラフに対して一貫している (版1では経路なし、版2では経路あり)
+    for (size_t i = 0; i < snapshot_results.size(); ++i) {
+        bool consistent = (snapshot_results[i].first == 1) == snapshot_results[i].second.first.empty();
+        std::cout << "\n読み手" << i << " の結果は取得した版と" << (consistent ? "一貫しています" : "矛盾しています");
+    }
+    auto latest_path = graph_data.get_snapshot()->get_shortest_path("A", "E", dummy_heuristic);
+    std::cout << "\n最新の版 " << graph_data.get_snapshot()->get_version() << " の経路A-E の最短経路は ";
+    print_vector(latest_path.first);
+    std::cout << " (重み: " << latest_path.second << ")" << std::endl;
+
+    // 探索の統計は探索ごとに返され、複数の探索の分を合計できる
+    SearchStats total_stats;
+    for (const auto& [from, to] : std::vector<std::pair<std::string, std::string>>{{"A", "E"}, {"B", "D"}, {"E", "A"}}) {
+        SearchResult result = graph_data.get_shortest_path_with_stats(from, to, dummy_heuristic);
+        std::cout << "\n経路" << from << "-" << to << ": 展開 " << result.stats.settled
+                  << ", 緩和 " << result.stats.relaxed << ", 追加 " << result.stats.heap_pushes
+                  << ", 取り出し " << result.stats.heap_pops << " (古い情報 " << result.stats.stale_pops << ")";
+        total_stats += result.stats;
+    }
+    std::cout << "\n合計 (" << total_stats.queries << " 回の探索): 展開 " << total_stats.settled
+              << ", 緩和 " << total_stats.relaxed << std::endl;
+
+    // 占有格子上の A* (隣接セルは座標から計算し、GraphData には変換しない)
+    OccupancyGrid grid = OccupancyGrid::from_rows({
+        "..........",
+        "....#.....",
+        "....#.###.",
+        "....#...#.",
+        "....###.#.",
+        "........#.",
+        ".######.#.",
+        "..........",
+    });
+    for (bool jump_point_search : {false, true}) {
+        auto [grid_path, grid_cost] = grid_a_star(grid, 0, 0, 9, 5, jump_point_search);
+        std::cout << "\n格子 (0,0)-(9,5) の最短経路" << (jump_point_search ? " (JPS)" : "") << ": ";
+        for (size_t i = 0; i < grid_path.size(); ++i) {
+            std::cout << (i == 0 ? "" : " ") << "(" << grid_path[i].first << "," << grid_path[i].second << ")";
+        }
+        std::cout << " (重み: " << grid_cost << ")";
+    }
+    std::cout << std::endl;
+    // 同じ作業領域で問い合わせを繰り返す (格子の大きさの配列は最初の問い合わせでだけ確保する)
+    GridSearchWorkspace grid_workspace;
+    const std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> grid_queries = {
+        {{0, 0}, {9, 7}}, {{9, 0}, {0, 7}}, {{5, 3}, {7, 3}}, {{0, 7}, {3, 1}}
+    };
+    std::cout << "\n格子の問い合わせ (作業領域を使い回す):" << std::endl;
+    for (const auto& query : grid_queries) {
+        double grid_cost = grid_a_star(grid, query.first.first, query.first.second,
+                                       query.second.first, query.second.second, grid_workspace, true).second;
+        std::cout << "  (" << query.first.first << "," << query.first.second << ")-(" << query.second.first << ","
+                  << query.second.second << ") の重み: " << grid_cost << std::endl;
+    }
+
     std::cout << "\nA-start TEST <----- end" << std::endl;
 
     return 0;
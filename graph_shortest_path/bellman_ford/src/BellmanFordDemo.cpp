@@ -11,16 +11,79 @@
 #include <tuple>
 #include <utility>
 #include <string>
+#include <type_traits>
 
-class GraphData {
+#include "../../common/src/CheckedArithmetic.h"
+
+// 探索ごとに使い回す作業領域です。
+// 各頂点の距離と先行頂点は版番号 (stamp) 付きで保持し、版番号が現在の探索と異なる値は
+// 未設定 (距離は無限大) とみなします。そのため reset は版番号を進めるだけの O(1) で済み、
+// 一度現れた頂点の記録は次の探索でもそのまま再利用されます (全頂点の初期化やメモリ確保を行いません)。
+// 1つの作業領域を複数のスレッドで同時に使うことはできません (スレッドごとに用意します)。
+template <typename Distance, typename Arithmetic = CheckedArithmetic<Distance>>
+class SearchWorkspace {
+private:
+    struct Entry {
+        unsigned int stamp = 0;
+        Distance dist = Distance();
+        std::string pred;
+    };
+    std::unordered_map<std::string, Entry> _entries;
+    unsigned int _current_stamp = 0;
+
+    const Entry* find(const std::string& vertex) const {
+        auto it = _entries.find(vertex);
+        if (it == _entries.end() || it->second.stamp != _current_stamp) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+public:
+    // 新しい探索を始めます。
+    void reset() {
+        // 版番号が一周した場合だけ全体を消去する
+        if (++_current_stamp == 0) {
+            for (auto& entry : _entries) {
+                entry.second.stamp = 0;
+            }
+            _current_stamp = 1;
+        }
+    }
+
+    Distance dist(const std::string& vertex) const {
+        const Entry* entry = find(vertex);
+        return entry == nullptr ? Arithmetic::infinity() : entry->dist;
+    }
+
+    // 先行頂点を返します。記録がない場合は空文字列を返します。
+    const std::string& pred(const std::string& vertex) const {
+        static const std::string none;
+        const Entry* entry = find(vertex);
+        return entry == nullptr ? none : entry->pred;
+    }
+
+    void set(const std::string& vertex, Distance dist, const std::string& pred) {
+        Entry& entry = _entries[vertex];
+        entry.stamp = _current_stamp;
+        entry.dist = dist;
+        entry.pred = pred;
+    }
+};
+
+// 辺の重みの型 Weight と距離の型 Distance を指定できるグラフです。
+// 例えば BasicGraphData<std::uint16_t, std::uint32_t> は重みを2バイトで保持し、距離を4バイトで計算します。
+// 距離の加算と無限大は Arithmetic (既定は CheckedArithmetic) に従います。
+template <typename Weight, typename Distance = Weight, typename Arithmetic = CheckedArithmetic<Distance>>
+class BasicGraphData {
 private:
     // キーは頂点、値はその頂点に隣接する頂点と重みのリストです
-    std::unordered_map<std::string, std::vector<std::pair<std::string, int>>> _data;
+    std::unordered_map<std::string, std::vector<std::pair<std::string, Weight>>> _data;
 
 public:
-    GraphData() {}
+    BasicGraphData() {}
 
-    std::unordered_map<std::string, std::vector<std::pair<std::string, int>>> get() {
+    std::unordered_map<std::string, std::vector<std::pair<std::string, Weight>>> get() {
         // グラフの内部データを取得します
         return _data;
     }
@@ -34,15 +97,15 @@ public:
         return vertices;
     }
 
-    std::vector<std::tuple<std::string, std::string, int>> get_edges() {
+    std::vector<std::tuple<std::string, std::string, Weight>> get_edges() {
         // グラフの全辺をリストとして返します
         // 各辺は (出発頂点, 到着頂点, 重み) のタプルになります
-        std::vector<std::tuple<std::string, std::string, int>> edges;
+        std::vector<std::tuple<std::string, std::string, Weight>> edges;
         for (const auto& pair : _data) {
             const std::string& u = pair.first;
             for (const auto& neighbor_weight : pair.second) {
                 const std::string& v = neighbor_weight.first;
-                int weight = neighbor_weight.second;
+                Weight weight = neighbor_weight.second;
                 edges.push_back(std::make_tuple(u, v, weight));
             }
         }
@@ -58,7 +121,7 @@ public:
         return true; // 既に存在する場合は追加しないがTrueを返す
     }
 
-    bool add_edge(const std::string& vertex1, const std::string& vertex2, int weight) {
+    bool add_edge(const std::string& vertex1, const std::string& vertex2, Weight weight) {
         // 両頂点間に辺を追加します。重みを指定します
         // 頂点がグラフに存在しない場合は追加します
         add_vertex(vertex1);
@@ -106,56 +169,55 @@ public:
         return true;
     }
 
-    std::pair<std::vector<std::string>, int> get_shortest_path(
+    std::pair<std::vector<std::string>, Distance> get_shortest_path(
         const std::string& start_vertex,
         const std::string& end_vertex,
-        int (*heuristic)(const std::string&, const std::string&)) {
+        Distance (*heuristic)(const std::string&, const std::string&)) {
         
-        std::vector<std::string> vertices = get_vertices();
-        std::vector<std::tuple<std::string, std::string, int>> edges = get_edges();
-        size_t num_vertices = vertices.size();
+        size_t num_vertices = _data.size();
 
         // 始点と終点の存在チェック
-        if (std::find(vertices.begin(), vertices.end(), start_vertex) == vertices.end()) {
+        if (_data.find(start_vertex) == _data.end()) {
             std::cout << "エラー: 始点 '" << start_vertex << "' がグラフに存在しません。" << std::endl;
-            return std::make_pair(std::vector<std::string>(), std::numeric_limits<int>::max());
+            return std::make_pair(std::vector<std::string>(), Arithmetic::infinity());
         }
-        if (std::find(vertices.begin(), vertices.end(), end_vertex) == vertices.end()) {
+        if (_data.find(end_vertex) == _data.end()) {
             std::cout << "エラー: 終点 '" << end_vertex << "' がグラフに存在しません。" << std::endl;
-            return std::make_pair(std::vector<std::string>(), std::numeric_limits<int>::max());
+            return std::make_pair(std::vector<std::string>(), Arithmetic::infinity());
         }
 
         // 始点と終点が同じ場合
         if (start_vertex == end_vertex) {
-            return std::make_pair(std::vector<std::string>{start_vertex}, 0);
+            return std::make_pair(std::vector<std::string>{start_vertex}, Distance());
         }
 
-        // 距離と先行頂点の初期化
-        std::unordered_map<std::string, int> dist;
-        std::unordered_map<std::string, std::string> pred;
-        
-        for (const auto& vertex : vertices) {
-            dist[vertex] = std::numeric_limits<int>::max();
-            pred[vertex] = "";
-        }
-        dist[start_vertex] = 0; // 始点自身の距離は0
+        // 距離と先行頂点は、スレッドごとの作業領域を使い回す
+        // (未記録の頂点の距離は無限大とみなすため、全頂点の初期化は行わない)
+        static thread_local SearchWorkspace<Distance, Arithmetic> workspace;
+        workspace.reset();
+        workspace.set(start_vertex, Distance(), ""); // 始点自身の距離は0
 
         // |V| - 1 回の緩和ステップを実行
+        // 辺は get_edges() で複製せず、隣接リストを直接走査する
         for (size_t i = 0; i < num_vertices - 1; ++i) {
             // 緩和が一度も行われなかった場合にループを中断するためのフラグ
             bool relaxed_in_this_iteration = false;
             
-            for (const auto& edge : edges) {
-                const std::string& u = std::get<0>(edge);
-                const std::string& v = std::get<1>(edge);
-                int weight = std::get<2>(edge);
-                
+            for (const auto& pair : _data) {
+                const std::string& u = pair.first;
+                Distance dist_u = workspace.dist(u);
                 // dist[u] が無限大でない場合のみ緩和を試みる
-                if (dist[u] != std::numeric_limits<int>::max() && 
-                    dist[u] + weight < dist[v]) {
-                    dist[v] = dist[u] + weight;
-                    pred[v] = u;
-                    relaxed_in_this_iteration = true;
+                if (dist_u == Arithmetic::infinity()) {
+                    continue;
+                }
+                for (const auto& neighbor_weight : pair.second) {
+                    const std::string& v = neighbor_weight.first;
+                    Weight weight = neighbor_weight.second;
+                    Distance dist_through_u = Arithmetic::add(dist_u, weight);
+                    if (dist_through_u < workspace.dist(v)) {
+                        workspace.set(v, dist_through_u, u);
+                        relaxed_in_this_iteration = true;
+                    }
                 }
             }
             
@@ -166,16 +228,18 @@ public:
         }
 
         // 負閉路の検出
-        for (const auto& edge : edges) {
-            const std::string& u = std::get<0>(edge);
-            const std::string& v = std::get<1>(edge);
-            int weight = std::get<2>(edge);
-            
-            if (dist[u] != std::numeric_limits<int>::max() && 
-                dist[u] + weight < dist[v]) {
-                // 負閉路が存在します
-                std::cout << "エラー: グラフに負閉路が存在します。最短経路は定義できません。" << std::endl;
-                return std::make_pair(std::vector<std::string>(), -std::numeric_limits<int>::max());
+        for (const auto& pair : _data) {
+            const std::string& u = pair.first;
+            Distance dist_u = workspace.dist(u);
+            if (dist_u == Arithmetic::infinity()) {
+                continue;
+            }
+            for (const auto& neighbor_weight : pair.second) {
+                if (Arithmetic::add(dist_u, neighbor_weight.second) < workspace.dist(neighbor_weight.first)) {
+                    // 負閉路が存在します
+                    std::cout << "エラー: グラフに負閉路が存在します。最短経路は定義できません。" << std::endl;
+                    return std::make_pair(std::vector<std::string>(), Arithmetic::negative_infinity());
+                }
             }
         }
 
@@ -184,8 +248,14 @@ public:
         std::string current = end_vertex;
 
         // 終点まで到達不可能かチェック
-        if (dist[end_vertex] == std::numeric_limits<int>::max()) {
-            return std::make_pair(std::vector<std::string>(), std::numeric_limits<int>::max());
+        if (workspace.dist(end_vertex) == Arithmetic::infinity()) {
+            return std::make_pair(std::vector<std::string>(), Arithmetic::infinity());
+        }
+
+        // 経路の重みが距離の型の範囲を超えた場合は、誤った距離を返さずにエラーにする
+        if (Arithmetic::is_overflow(workspace.dist(end_vertex))) {
+            std::cout << "エラー: 経路の重みが距離の型の範囲を超えました。" << std::endl;
+            return std::make_pair(std::vector<std::string>(), workspace.dist(end_vertex));
         }
 
         // 終点から先行頂点をたどって経路を逆順に構築
@@ -196,21 +266,24 @@ public:
                 break;
             }
             // 次の頂点に進む
-            current = pred[current];
+            current = workspace.pred(current);
         }
 
         // 経路が始点から始まっていない場合
         if (path.empty() || path.back() != start_vertex) {
-            return std::make_pair(std::vector<std::string>(), std::numeric_limits<int>::max());
+            return std::make_pair(std::vector<std::string>(), Arithmetic::infinity());
         }
 
         // 経路を始点から終点の順にする
         std::reverse(path.begin(), path.end());
 
-        return std::make_pair(path, dist[end_vertex]);
+        return std::make_pair(path, workspace.dist(end_vertex));
     }
 };
 
+// これまでどおり int の重みと距離を使うグラフ
+typedef BasicGraphData<int> GraphData;
+
 // ヒューリスティック関数 (ベルマン-フォード法では使用しないが、元のコードに合わせた引数のために残す)
 int dummy_heuristic(const std::string& u, const std::string& v) {
     // u と v の間に何らかの推定距離を計算する関数
@@ -332,6 +405,38 @@ int main() {
     print_vector(shortest_path.first);
     std::cout << " (重み: " << shortest_path.second << ")" << std::endl;
 
+    // 距離が int の範囲を超える場合は、誤った距離を返さずにエラーになる (Arithmetic::is_overflow で判定できる値を返す)
+    std::cout << std::endl;
+    graph_data.clear();
+    const int large_weight = std::numeric_limits<int>::max() / 2 + 1;
+    graph_data.add_edge("A", "B", large_weight);
+    graph_data.add_edge("B", "C", large_weight);
+    shortest_path = graph_data.get_shortest_path("A", "C", dummy_heuristic);
+    std::cout << "経路A-C (重み " << large_weight << " の辺2本) は ";
+    if (CheckedArithmetic<int>::is_overflow(shortest_path.second)) {
+        std::cout << "距離が int の範囲を超えました。" << std::endl;
+    } else {
+        print_vector(shortest_path.first);
+        std::cout << " (重み: " << shortest_path.second << ")" << std::endl;
+    }
+
+    // 2バイトの重みと4バイトの距離、浮動小数点数の重みと距離
+    BasicGraphData<unsigned short, unsigned int> compact_graph;
+    BasicGraphData<double> double_graph;
+    inputList = {{"A", "B", 4}, {"B", "C", 3}, {"B", "D", 2}, {"D", "A", 1}, {"A", "C", 2}};
+    for (const auto& input : inputList) {
+        compact_graph.add_edge(std::get<0>(input), std::get<1>(input), static_cast<unsigned short>(std::get<2>(input)));
+        double_graph.add_edge(std::get<0>(input), std::get<1>(input), std::get<2>(input) / 2.0);
+    }
+    auto compact_path = compact_graph.get_shortest_path("C", "D", nullptr);
+    std::cout << "unsigned short の重み: 経路C-D の最短経路は ";
+    print_vector(compact_path.first);
+    std::cout << " (重み: " << compact_path.second << ")" << std::endl;
+    auto double_path = double_graph.get_shortest_path("C", "D", nullptr);
+    std::cout << "double の重み (半分): 経路C-D の最短経路は ";
+    print_vector(double_path.first);
+    std::cout << " (重み: " << double_path.second << ")" << std::endl;
+
     std::cout << "\nBellmanFord TEST <----- end" << std::endl;
 
     return 0;
@@ -0,0 +1,84 @@
+// C++
+// 最短経路の共通部品: 距離の無限大と範囲を確認する加算
+//
+// ダイクストラ法、A*、ベルマンフォード法、ワーシャルフロイド法のデモと、グラフのベンチマークで共有します。
+
+#ifndef CHECKED_ARITHMETIC_H
+#define CHECKED_ARITHMETIC_H
+
+#include <limits>
+#include <type_traits>
+
+// 距離の無限大の表し方と加算を決めるポリシーです。
+// 整数型では最大値を無限大 (到達不可能) とみなし、その1つ下の値 overflow() を
+// 「経路はあるが距離が型の範囲を超えた」ことを表す値として予約します。
+// 負の重みで型の最小値を下回った場合は、符号付きの型の最小値 underflow() になります。
+// 範囲を超えた値にさらに加算しても範囲を超えたままなので、探索の結果の距離を is_overflow で調べれば、
+// 途中で範囲を超えた経路を誤った有限の距離として受け取ることはありません。
+// 浮動小数点型では IEEE の無限大をそのまま使い、有限の距離の和が無限大になる場合は型の最大値 (負の側は最小値) にします。
+// 同じ関数を持つ別の型を指定すれば、独自の距離の型や演算を使えます。
+template <typename T>
+struct CheckedArithmetic {
+    static T infinity() {
+        return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                    : std::numeric_limits<T>::max();
+    }
+
+    // 距離が型の範囲を上に超えたことを表す値
+    static T overflow() {
+        return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::max()
+                                                    : static_cast<T>(std::numeric_limits<T>::max() - 1);
+    }
+
+    // 距離が型の範囲を下に超えたことを表す値 (符号付きの型だけで使います)
+    static T underflow() {
+        return std::numeric_limits<T>::lowest();
+    }
+
+    // 負閉路があるときに返す距離
+    static T negative_infinity() {
+        return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                    : std::numeric_limits<T>::lowest() + std::numeric_limits<T>::is_signed;
+    }
+
+    // 距離が型の範囲を超えた (正しい距離を表していない) かどうかを返します。
+    static bool is_overflow(T distance) {
+        return distance == overflow() || (std::numeric_limits<T>::is_signed && distance == underflow());
+    }
+
+    // distance + weight を返します。どちらかが無限大なら無限大です。
+    // 和や重みが T で表せない場合、またはどちらかが既に範囲を超えている場合は overflow() か underflow() です。
+    template <typename W>
+    static T add(T distance, W weight) {
+        const T increment = static_cast<T>(weight);
+        if (distance == infinity()) {
+            return infinity();
+        }
+        if (is_overflow(distance)) {
+            return distance;
+        }
+        if (std::is_integral<W>::value &&
+            (static_cast<W>(increment) != weight || (increment < T()) != (weight < W()))) {
+            return weight < W() && std::numeric_limits<T>::is_signed ? underflow() : overflow();
+        }
+        if (increment == infinity()) {
+            return infinity();
+        }
+        if (!std::is_floating_point<T>::value) {
+            if (increment > T() && distance >= overflow() - increment) {
+                return overflow();
+            }
+            if (increment < T() && distance <= underflow() - increment) {
+                return underflow();
+            }
+            return static_cast<T>(distance + increment);
+        }
+        const T sum = distance + increment;
+        if (sum >= overflow()) {
+            return overflow();
+        }
+        return sum <= underflow() ? underflow() : sum;
+    }
+};
+
+#endif
@@ -9,18 +9,723 @@
 #include <limits>
 #include <algorithm>
 #include <string>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <type_traits>
+
+#include "../../common/src/CheckedArithmetic.h"
+
+// 頂点名を整数IDに置き換えた CSR (Compressed Sparse Row) 形式の隣接表現です。
+// 頂点 v の隣接辺は targets/weights の [offsets[v], offsets[v + 1]) に連続して並びます。
+// 重みの型は Weight で、例えば BasicCsrGraph<unsigned short> は探索で読む重みの配列が int の半分になります。
+template <typename Weight>
+struct BasicCsrGraph {
+    std::vector<std::string> names;              // ID -> 頂点名
+    std::unordered_map<std::string, int> index;  // 頂点名 -> ID
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<Weight> weights;
+
+    int num_vertices() const {
+        return static_cast<int>(names.size());
+    }
+
+    int degree(int vertex) const {
+        return offsets[vertex + 1] - offsets[vertex];
+    }
+
+    // 頂点 vertex の隣接辺ごとに visit(隣接頂点ID, 重み) を呼び出します。
+    template <typename Visitor>
+    void for_each_edge(int vertex, Visitor visit) const {
+        for (int e = offsets[vertex]; e < offsets[vertex + 1]; ++e) {
+            visit(targets[e], weights[e]);
+        }
+    }
+
+    // 隣接表現 (頂点名を除く) が使うメモリのバイト数
+    size_t memory_bytes() const {
+        return (offsets.capacity() + targets.capacity()) * sizeof(int) + weights.capacity() * sizeof(Weight);
+    }
+};
+
+typedef BasicCsrGraph<int> CsrGraph;
+
+// 重みを Weight 型に変換した CSR を作ります。頂点IDと names/index はそのまま引き継ぎます。
+// Weight で表せない重み (範囲外や符号が変わるもの) があれば false を返し、converted は変更しません。
+template <typename Weight, typename Source>
+bool convert_csr_weights(const BasicCsrGraph<Source>& csr, BasicCsrGraph<Weight>& converted) {
+    std::vector<Weight> weights;
+    weights.reserve(csr.weights.size());
+    for (Source weight : csr.weights) {
+        Weight value = static_cast<Weight>(weight);
+        if (static_cast<Source>(value) != weight || (value < Weight()) != (weight < Source())) {
+            return false;
+        }
+        weights.push_back(value);
+    }
+    converted.names = csr.names;
+    converted.index = csr.index;
+    converted.offsets = csr.offsets;
+    converted.targets = csr.targets;
+    converted.weights = std::move(weights);
+    return true;
+}
+
+// CSR を作るときの頂点IDの振り方です。
+// 探索で続けて訪れる頂点に近いIDを振ると、距離や隣接辺の配列へのアクセスが局所化されます。
+enum class VertexOrder {
+    Name,       // 頂点名の順 (既定)
+    Bfs,        // 幅優先探索で訪れた順
+    Rcm,        // 逆 Cuthill-McKee 順 (隣接行列の帯幅を小さくする)
+    Degree      // 次数の大きい順
+};
+
+// 頂点の並べ方 order に従って、新しいID -> 元のID の対応表を作ります。
+template <typename Weight>
+std::vector<int> compute_vertex_order(const BasicCsrGraph<Weight>& csr, VertexOrder order) {
+    const int num_vertices = csr.num_vertices();
+    std::vector<int> new_to_old(num_vertices);
+    for (int v = 0; v < num_vertices; ++v) {
+        new_to_old[v] = v;
+    }
+    auto degree = [&csr](int v) {
+        return csr.offsets[v + 1] - csr.offsets[v];
+    };
+
+    if (order == VertexOrder::Degree) {
+        std::stable_sort(new_to_old.begin(), new_to_old.end(), [&degree](int a, int b) {
+            return degree(a) > degree(b);
+        });
+    } else if (order == VertexOrder::Bfs || order == VertexOrder::Rcm) {
+        // RCM では各連結成分を次数が最小の頂点から始め、隣接頂点を次数の小さい順に訪れる
+        std::vector<int> roots = new_to_old;
+        if (order == VertexOrder::Rcm) {
+            std::stable_sort(roots.begin(), roots.end(), [&degree](int a, int b) {
+                return degree(a) < degree(b);
+            });
+        }
+        std::vector<char> visited(num_vertices, 0);
+        std::vector<int> neighbors;
+        size_t head = 0;
+        size_t tail = 0;
+        for (int root : roots) {
+            if (visited[root]) {
+                continue;
+            }
+            visited[root] = 1;
+            new_to_old[tail++] = root;
+            while (head < tail) {
+                int u = new_to_old[head++];
+                neighbors.clear();
+                for (int e = csr.offsets[u]; e < csr.offsets[u + 1]; ++e) {
+                    if (!visited[csr.targets[e]]) {
+                        visited[csr.targets[e]] = 1;
+                        neighbors.push_back(csr.targets[e]);
+                    }
+                }
+                if (order == VertexOrder::Rcm) {
+                    std::stable_sort(neighbors.begin(), neighbors.end(), [&degree](int a, int b) {
+                        return degree(a) < degree(b);
+                    });
+                }
+                for (int v : neighbors) {
+                    new_to_old[tail++] = v;
+                }
+            }
+        }
+        if (order == VertexOrder::Rcm) {
+            std::reverse(new_to_old.begin(), new_to_old.end());
+        }
+    }
+    return new_to_old;
+}
+
+// 頂点のIDを振り直した CSR を作ります。
+// 各頂点の隣接辺は新しいIDの昇順に並べ替え、names/index は元の頂点名との対応を保ちます。
+template <typename Weight>
+BasicCsrGraph<Weight> reorder_csr(const BasicCsrGraph<Weight>& csr, VertexOrder order) {
+    if (order == VertexOrder::Name) {
+        return csr;
+    }
+    const int num_vertices = csr.num_vertices();
+    std::vector<int> new_to_old = compute_vertex_order(csr, order);
+    std::vector<int> old_to_new(num_vertices);
+    for (int v = 0; v < num_vertices; ++v) {
+        old_to_new[new_to_old[v]] = v;
+    }
+
+    BasicCsrGraph<Weight> reordered;
+    reordered.names.reserve(num_vertices);
+    reordered.offsets.reserve(num_vertices + 1);
+    reordered.targets.reserve(csr.targets.size());
+    reordered.weights.reserve(csr.weights.size());
+    reordered.offsets.push_back(0);
+    std::vector<std::pair<int, Weight>> edges;
+    for (int v = 0; v < num_vertices; ++v) {
+        int old_vertex = new_to_old[v];
+        reordered.index[csr.names[old_vertex]] = v;
+        reordered.names.push_back(csr.names[old_vertex]);
+
+        edges.clear();
+        for (int e = csr.offsets[old_vertex]; e < csr.offsets[old_vertex + 1]; ++e) {
+            edges.push_back(std::make_pair(old_to_new[csr.targets[e]], csr.weights[e]));
+        }
+        std::stable_sort(edges.begin(), edges.end(), [](const std::pair<int, Weight>& a, const std::pair<int, Weight>& b) {
+            return a.first < b.first;
+        });
+        for (const auto& edge : edges) {
+            reordered.targets.push_back(edge.first);
+            reordered.weights.push_back(edge.second);
+        }
+        reordered.offsets.push_back(static_cast<int>(reordered.targets.size()));
+    }
+    return reordered;
+}
+
+// 符号なし整数を可変長 (1バイトあたり7ビット、最上位ビットが継続の印) で末尾に追加します。
+template <typename Unsigned>
+void encode_varint(std::vector<unsigned char>& bytes, Unsigned value) {
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<unsigned char>(value));
+}
+
+// position から Unsigned 型の可変長の整数を1つ読み、position を次の整数の先頭に進めます。
+template <typename Unsigned = unsigned int>
+Unsigned decode_varint(const unsigned char*& position) {
+    Unsigned value = *position & 0x7f;
+    int shift = 7;
+    while (*position++ & 0x80) {
+        value |= static_cast<Unsigned>(*position & 0x7f) << shift;
+        shift += 7;
+    }
+    return value;
+}
+
+// 負の重みも短く符号化できるように、0, -1, 1, -2, ... を 0, 1, 2, 3, ... に対応させます。
+// 符号なしの型はそのまま返します。
+template <typename Integer>
+typename std::make_unsigned<Integer>::type zigzag_encode(Integer value) {
+    typedef typename std::make_unsigned<Integer>::type Unsigned;
+    if (!std::is_signed<Integer>::value) {
+        return static_cast<Unsigned>(value);
+    }
+    return (static_cast<Unsigned>(value) << 1) ^ static_cast<Unsigned>(value < 0 ? ~Unsigned() : Unsigned());
+}
+
+template <typename Integer>
+Integer zigzag_decode(typename std::make_unsigned<Integer>::type value) {
+    typedef typename std::make_unsigned<Integer>::type Unsigned;
+    if (!std::is_signed<Integer>::value) {
+        return static_cast<Integer>(value);
+    }
+    return static_cast<Integer>((value >> 1) ^ (Unsigned() - (value & 1)));
+}
+
+// 隣接リストを圧縮して保持する CSR 形式の隣接表現です。BasicCsrGraph と同じ方法で探索できます。
+// 頂点ごとに次数、続いて (隣接頂点IDの前の辺との差, 重み) の組を可変長整数で並べます。
+// 隣接頂点IDは昇順に並べ替えてあるため差は小さく、多くの辺は2〜3バイトに収まります。
+// 隣接辺は for_each_edge の中で先頭から順に復号します。重みの型 Weight は整数型に限ります。
+template <typename Weight>
+struct BasicCompressedCsrGraph {
+    static_assert(std::is_integral<Weight>::value, "圧縮できるのは整数の重みだけです");
+    typedef typename std::make_unsigned<Weight>::type EncodedWeight;
+
+    std::vector<std::string> names;              // ID -> 頂点名
+    std::unordered_map<std::string, int> index;  // 頂点名 -> ID
+    std::vector<size_t> offsets;                 // 頂点ごとの bytes の開始位置
+    std::vector<unsigned char> bytes;
+
+    int num_vertices() const {
+        return static_cast<int>(names.size());
+    }
+
+    int degree(int vertex) const {
+        const unsigned char* position = bytes.data() + offsets[vertex];
+        return static_cast<int>(decode_varint(position));
+    }
+
+    // 頂点 vertex の隣接辺ごとに visit(隣接頂点ID, 重み) を呼び出します。
+    template <typename Visitor>
+    void for_each_edge(int vertex, Visitor visit) const {
+        const unsigned char* position = bytes.data() + offsets[vertex];
+        unsigned int remaining = decode_varint(position);
+        int target = 0;
+        while (remaining-- > 0) {
+            target += static_cast<int>(decode_varint(position));
+            visit(target, zigzag_decode<Weight>(decode_varint<EncodedWeight>(position)));
+        }
+    }
+
+    // 隣接表現 (頂点名を除く) が使うメモリのバイト数
+    size_t memory_bytes() const {
+        return offsets.capacity() * sizeof(size_t) + bytes.capacity();
+    }
+};
+
+typedef BasicCompressedCsrGraph<int> CompressedCsrGraph;
+
+// CSR 形式のグラフを圧縮します。頂点IDと names/index はそのまま引き継ぎます。
+template <typename Weight>
+BasicCompressedCsrGraph<Weight> compress_csr(const BasicCsrGraph<Weight>& csr) {
+    const int num_vertices = csr.num_vertices();
+    BasicCompressedCsrGraph<Weight> compressed;
+    compressed.names = csr.names;
+    compressed.index = csr.index;
+    compressed.offsets.reserve(num_vertices + 1);
+    std::vector<std::pair<int, Weight>> edges;
+    for (int v = 0; v < num_vertices; ++v) {
+        compressed.offsets.push_back(compressed.bytes.size());
+        edges.clear();
+        csr.for_each_edge(v, [&edges](int target, Weight weight) {
+            edges.push_back(std::make_pair(target, weight));
+        });
+        std::stable_sort(edges.begin(), edges.end(), [](const std::pair<int, Weight>& a, const std::pair<int, Weight>& b) {
+            return a.first < b.first;
+        });
+        encode_varint(compressed.bytes, static_cast<unsigned int>(edges.size()));
+        int previous = 0;
+        for (const auto& edge : edges) {
+            encode_varint(compressed.bytes, static_cast<unsigned int>(edge.first - previous));
+            encode_varint(compressed.bytes, zigzag_encode(edge.second));
+            previous = edge.first;
+        }
+    }
+    compressed.offsets.push_back(compressed.bytes.size());
+    compressed.bytes.shrink_to_fit();
+    return compressed;
+}
+
+// 探索ごとに使い回す作業領域です。
+// 各頂点の距離と直前の頂点は版番号 (stamp) 付きで保持し、版番号が現在の探索と異なる値は
+// 未設定 (距離は無限大) とみなします。そのため reset は版番号を進めるだけの O(1) で済み、
+// 同じ大きさのグラフに対する繰り返しの探索ではメモリを確保しません。
+// 距離は Distance 型で保持し、加算と無限大は Arithmetic (既定は CheckedArithmetic) に従います。
+// 1つの作業領域を複数のスレッドで同時に使うことはできません (スレッドごとに用意します)。
+template <typename Distance = double, typename Arithmetic = CheckedArithmetic<Distance>>
+class BasicSearchWorkspace {
+private:
+    std::vector<Distance> _distances;
+    std::vector<int> _predecessors;
+    std::vector<unsigned int> _stamps;
+    unsigned int _current_stamp = 0;
+
+public:
+    // 優先度付きキューとして使うヒープ (推定距離, 頂点ID)
+    std::vector<std::pair<Distance, int>> heap;
+
+    // 頂点数 num_vertices のグラフに対する新しい探索を始めます。
+    void reset(int num_vertices) {
+        if (_stamps.size() < static_cast<size_t>(num_vertices)) {
+            _distances.resize(num_vertices);
+            _predecessors.resize(num_vertices);
+            _stamps.resize(num_vertices, 0);
+        }
+        // 版番号が一周した場合だけ全体を消去する
+        if (++_current_stamp == 0) {
+            std::fill(_stamps.begin(), _stamps.end(), 0);
+            _current_stamp = 1;
+        }
+        heap.clear();
+    }
+
+    // 頂点の距離が現在の探索で設定済みかどうかを返します。
+    bool is_reached(int vertex) const {
+        return _stamps[vertex] == _current_stamp;
+    }
+
+    Distance distance(int vertex) const {
+        return is_reached(vertex) ? _distances[vertex] : Arithmetic::infinity();
+    }
+
+    int predecessor(int vertex) const {
+        return is_reached(vertex) ? _predecessors[vertex] : -1;
+    }
+
+    void set(int vertex, Distance distance, int predecessor) {
+        _stamps[vertex] = _current_stamp;
+        _distances[vertex] = distance;
+        _predecessors[vertex] = predecessor;
+    }
+};
+
+typedef BasicSearchWorkspace<> SearchWorkspace;
+
+// SEARCH_STATS を 0 に定義してコンパイルすると、探索の統計を集計するコードはすべて取り除かれます。
+#ifndef SEARCH_STATS
+#define SEARCH_STATS 1
+#endif
+
+// 1回 (または複数回) の探索の統計です。+= で複数の探索の統計を合計できます。
+struct SearchStats {
+    unsigned long long queries = 0;          // 探索の回数
+    unsigned long long settled = 0;          // 確定した頂点の数
+    unsigned long long relaxed = 0;          // 距離を更新した辺の数
+    unsigned long long scanned = 0;          // 調べた辺の数
+    unsigned long long heap_pushes = 0;      // キューへの追加回数
+    unsigned long long heap_pops = 0;        // キューからの取り出し回数
+    unsigned long long stale_pops = 0;       // 取り出したが古い情報だったため捨てた回数
+    double init_seconds = 0;                 // 初期化にかかった時間
+    double search_seconds = 0;               // 探索にかかった時間
+    double path_seconds = 0;                 // 経路の再構築にかかった時間
+
+    SearchStats& operator+=(const SearchStats& other) {
+        queries += other.queries;
+        settled += other.settled;
+        relaxed += other.relaxed;
+        scanned += other.scanned;
+        heap_pushes += other.heap_pushes;
+        heap_pops += other.heap_pops;
+        stale_pops += other.stale_pops;
+        init_seconds += other.init_seconds;
+        search_seconds += other.search_seconds;
+        path_seconds += other.path_seconds;
+        return *this;
+    }
+};
+
+// 統計を集計する場合だけ現在時刻を読みます。
+inline std::chrono::steady_clock::time_point stats_clock(const SearchStats* stats) {
+    return SEARCH_STATS && stats != nullptr ? std::chrono::steady_clock::now()
+                                            : std::chrono::steady_clock::time_point();
+}
+
+// 前回の時刻からの経過秒数を返し、前回の時刻を現在時刻に更新します。
+inline double stats_lap(std::chrono::steady_clock::time_point& last) {
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - last).count();
+    last = now;
+    return seconds;
+}
+
+// 常に true を返す辺の条件です (すべての辺を使います)。
+struct AllEdges {
+    bool operator()(int, int) const {
+        return true;
+    }
+};
+
+// CSR 形式のグラフ (BasicCsrGraph または CompressedCsrGraph) 上で、頂点ID source から target への最短距離を求めます。
+// 経路は作業領域の直前の頂点 (workspace.predecessor) に残ります。到達できなければ無限大を返し、
+// 距離が Distance 型の範囲を超えた場合は Arithmetic::is_overflow が true になる値を返します。
+// estimate(頂点ID) は終点までの距離の下界を返す関数で (A*)、常に0ならダイクストラ法と同じです。
+// allow_edge(u, v) が false を返す辺 u -> v は使いません (辺や頂点を取り除いた探索に使います)。
+// 終点までの距離が bound を超えることが分かった時点で探索を打ち切り、無限大を返します。
+// stats を指定すると、探索の統計をそこに加算します (経路の再構築の時間は含みません)。
+template <typename Graph, typename Distance, typename Arithmetic, typename Estimate, typename EdgeFilter>
+Distance csr_shortest_path(
+    const Graph& csr,
+    int source,
+    int target,
+    Estimate estimate,
+    EdgeFilter allow_edge,
+    Distance bound,
+    BasicSearchWorkspace<Distance, Arithmetic>& workspace,
+    SearchStats* stats = nullptr
+) {
+    const Distance infinity = Arithmetic::infinity();
+    const bool collect = SEARCH_STATS && stats != nullptr;
+    auto last_time = stats_clock(stats);
+    if (collect) {
+        ++stats->queries;
+    }
+
+    // (推定合計距離, 頂点) のペアを推定合計距離が小さい順に取り出す
+    typedef std::pair<Distance, int> PQElement;
+    std::greater<PQElement> heap_compare;
+    std::vector<PQElement>& heap = workspace.heap;
+    workspace.reset(csr.num_vertices());
+    workspace.set(source, Distance(), -1);
+    heap.push_back(std::make_pair(Arithmetic::add(Distance(), estimate(source)), source));
+    if (collect) {
+        ++stats->heap_pushes;
+        stats->init_seconds += stats_lap(last_time);
+    }
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), heap_compare);
+        Distance estimated_distance = heap.back().first;
+        int u = heap.back().second;
+        heap.pop_back();
+        Distance distance_u = workspace.distance(u);
+        if (collect) {
+            ++stats->heap_pops;
+        }
+        if (estimated_distance > Arithmetic::add(distance_u, estimate(u))) {
+            if (collect) {
+                ++stats->stale_pops;
+            }
+            continue;
+        }
+        // 残りの頂点を経由する経路はどれも bound より長い
+        if (estimated_distance > bound) {
+            break;
+        }
+        if (collect) {
+            ++stats->settled;
+        }
+        if (u == target) {
+            break;
+        }
+        csr.for_each_edge(u, [&](int v, auto weight) {
+            if (!allow_edge(u, v)) {
+                return;
+            }
+            Distance distance_through_u = Arithmetic::add(distance_u, weight);
+            if (distance_through_u < workspace.distance(v)) {
+                Distance estimated_through_u = Arithmetic::add(distance_through_u, estimate(v));
+                if (estimated_through_u > bound) {
+                    return;
+                }
+                workspace.set(v, distance_through_u, u);
+                heap.push_back(std::make_pair(estimated_through_u, v));
+                std::push_heap(heap.begin(), heap.end(), heap_compare);
+                if (collect) {
+                    ++stats->relaxed;
+                    ++stats->heap_pushes;
+                }
+            }
+        });
+        if (collect) {
+            stats->scanned += csr.degree(u);
+        }
+    }
+    if (collect) {
+        stats->search_seconds += stats_lap(last_time);
+    }
+    return workspace.is_reached(target) ? workspace.distance(target) : infinity;
+}
+
+// CSR 形式のグラフ (BasicCsrGraph または CompressedCsrGraph) 上で、作業領域を使って最短経路を取得します。
+// 距離は作業領域の Distance 型で求め、加算は Arithmetic に従います。
+// 経路はあるが距離が型の範囲を超えた場合は、空の経路と Arithmetic::is_overflow が true になる距離を返します。
+// heuristic には終了頂点までの距離の下界を返す関数を指定でき (A*)、
+// 常に0を返す関数または nullptr ならダイクストラ法と同じです (整数の距離では下界の小数部分を切り捨てます)。
+// stats を指定すると、探索の統計をそこに加算します。
+template <typename Graph, typename Distance, typename Arithmetic>
+std::pair<std::vector<std::string>, Distance> csr_shortest_path(
+    const Graph& csr,
+    const std::string& start_vertex, 
+    const std::string& end_vertex, 
+    double (*heuristic)(const std::string&, const std::string&),
+    BasicSearchWorkspace<Distance, Arithmetic>& workspace,
+    SearchStats* stats = nullptr
+) {
+    const Distance infinity = Arithmetic::infinity();
+    auto start_it = csr.index.find(start_vertex);
+    auto end_it = csr.index.find(end_vertex);
+    if (start_it == csr.index.end() || end_it == csr.index.end()) {
+        if (SEARCH_STATS && stats != nullptr) {
+            ++stats->queries;
+        }
+        return std::make_pair(std::vector<std::string>(), infinity);
+    }
+    const int target = end_it->second;
+    auto estimate = [&](int vertex) {
+        return heuristic == nullptr ? 0.0 : heuristic(csr.names[vertex], end_vertex);
+    };
+    Distance distance = csr_shortest_path(csr, start_it->second, target, estimate, AllEdges(), infinity, workspace, stats);
+    if (distance == infinity || Arithmetic::is_overflow(distance)) {
+        return std::make_pair(std::vector<std::string>(), distance);
+    }
+
+    auto last_time = stats_clock(stats);
+    std::vector<std::string> path;
+    for (int v = target; v != -1; v = workspace.predecessor(v)) {
+        path.push_back(csr.names[v]);
+    }
+    std::reverse(path.begin(), path.end());
+    if (SEARCH_STATS && stats != nullptr) {
+        stats->path_seconds += stats_lap(last_time);
+    }
+    return std::make_pair(path, distance);
+}
+
+// 始点 source から距離 radius 以内の頂点を、確定した順 (距離の小さい順) に visit(頂点ID, 距離) で通知します。
+// visit が false を返すと、その時点で探索を打ち切ります (確定済みの頂点の距離は作業領域に残ります)。
+// radius を超える頂点はキューに積まないため、手間は範囲内の頂点とその隣接辺の数だけで決まります。
+template <typename Graph, typename Distance, typename Arithmetic, typename Visitor>
+void csr_bounded_search(
+    const Graph& csr,
+    int source,
+    Distance radius,
+    BasicSearchWorkspace<Distance, Arithmetic>& workspace,
+    Visitor visit
+) {
+    typedef std::pair<Distance, int> PQElement;
+    std::greater<PQElement> heap_compare;
+    std::vector<PQElement>& heap = workspace.heap;
+    workspace.reset(csr.num_vertices());
+    if (radius < Distance()) {
+        return;
+    }
+    workspace.set(source, Distance(), -1);
+    heap.push_back(std::make_pair(Distance(), source));
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), heap_compare);
+        Distance distance_u = heap.back().first;
+        int u = heap.back().second;
+        heap.pop_back();
+        if (distance_u > workspace.distance(u)) {
+            continue;
+        }
+        if (!visit(u, distance_u)) {
+            return;
+        }
+        csr.for_each_edge(u, [&](int v, auto weight) {
+            Distance distance_through_u = Arithmetic::add(distance_u, weight);
+            if (distance_through_u <= radius && distance_through_u < workspace.distance(v)) {
+                workspace.set(v, distance_through_u, u);
+                heap.push_back(std::make_pair(distance_through_u, v));
+                std::push_heap(heap.begin(), heap.end(), heap_compare);
+            }
+        });
+    }
+}
+
+// 始点 source から距離 radius 以内の頂点を、確定した順に (頂点ID, 距離) として result に追加します。
+template <typename Graph, typename Distance, typename Arithmetic>
+void csr_bounded_search(
+    const Graph& csr,
+    int source,
+    Distance radius,
+    BasicSearchWorkspace<Distance, Arithmetic>& workspace,
+    std::vector<std::pair<int, Distance>>& result
+) {
+    csr_bounded_search(csr, source, radius, workspace, [&result](int vertex, Distance distance) {
+        result.push_back(std::make_pair(vertex, distance));
+        return true;
+    });
+}
+
+// 経路・距離と、その探索の統計をまとめた結果です。
+template <typename Distance = double>
+struct BasicSearchResult {
+    std::vector<std::string> path;
+    Distance distance;
+    SearchStats stats;
+};
+
+typedef BasicSearchResult<> SearchResult;
+
+// ある時点のグラフを CSR 形式で固定した、変更されない読み取り専用のスナップショットです。
+// 複数のスレッドが同じスナップショットに対してロックなしで同時に探索できます。
+template <typename Weight, typename Distance = Weight, typename Arithmetic = CheckedArithmetic<Distance>>
+class BasicGraphSnapshot {
+private:
+    BasicCsrGraph<Weight> _csr;
+    unsigned long _version;
+
+public:
+    BasicGraphSnapshot(BasicCsrGraph<Weight> csr, unsigned long version) : _csr(std::move(csr)), _version(version) {}
+
+    // スナップショットの版番号を返します (公開するたびに1ずつ増えます)。
+    unsigned long get_version() const {
+        return _version;
+    }
+
+    const BasicCsrGraph<Weight>& get_csr() const {
+        return _csr;
+    }
+
+    // スナップショット上で最短経路を取得します。
+    // 作業領域は呼び出し元のスレッドごとのものを使い回します。
+    std::pair<std::vector<std::string>, Distance> get_shortest_path(
+        const std::string& start_vertex, 
+        const std::string& end_vertex, 
+        double (*heuristic)(const std::string&, const std::string&)
+    ) const {
+        static thread_local BasicSearchWorkspace<Distance, Arithmetic> workspace;
+        return csr_shortest_path(_csr, start_vertex, end_vertex, heuristic, workspace);
+    }
+
+    // 指定した作業領域を使って最短経路を取得します。
+    std::pair<std::vector<std::string>, Distance> get_shortest_path(
+        const std::string& start_vertex, 
+        const std::string& end_vertex, 
+        double (*heuristic)(const std::string&, const std::string&),
+        BasicSearchWorkspace<Distance, Arithmetic>& workspace
+    ) const {
+        return csr_shortest_path(_csr, start_vertex, end_vertex, heuristic, workspace);
+    }
+
+    // スナップショット上で最短経路を取得し、探索の統計と一緒に返します。
+    BasicSearchResult<Distance> get_shortest_path_with_stats(
+        const std::string& start_vertex, 
+        const std::string& end_vertex, 
+        double (*heuristic)(const std::string&, const std::string&)
+    ) const {
+        static thread_local BasicSearchWorkspace<Distance, Arithmetic> workspace;
+        BasicSearchResult<Distance> result;
+        auto path_distance = csr_shortest_path(_csr, start_vertex, end_vertex, heuristic, workspace, &result.stats);
+        result.path = std::move(path_distance.first);
+        result.distance = path_distance.second;
+        return result;
+    }
+};
+
+typedef BasicGraphSnapshot<int, double> GraphSnapshot;
+
+// 辺の重みの変更履歴の1件分です。同じ辺の変更は1件にまとめ、
+// old_weight は木に最後に反映した時点の重み、new_weight は最新の重みを表します。
+// 新しく追加された辺の場合、existed は false で old_weight は意味を持ちません。
+template <typename Weight>
+struct BasicEdgeWeightChange {
+    std::string vertex1;
+    std::string vertex2;
+    bool existed;
+    Weight old_weight;
+    Weight new_weight;
+};
+
+typedef BasicEdgeWeightChange<int> EdgeWeightChange;
+
+// 辺の重みの型 Weight と距離の型 Distance を指定できるグラフです。
+// 距離の無限大と加算は Arithmetic に従い、既定の CheckedArithmetic では距離が型の範囲を超えたことを結果で確認できます。
+template <typename Weight, typename Distance = Weight, typename Arithmetic = CheckedArithmetic<Distance>>
+class BasicGraphData {
+public:
+    typedef BasicCsrGraph<Weight> Csr;
+    typedef BasicGraphSnapshot<Weight, Distance, Arithmetic> Snapshot;
+    typedef BasicSearchWorkspace<Distance, Arithmetic> Workspace;
 
-class GraphData {
 private:
     // 隣接ノードとその辺の重みを格納します。
     // キーは頂点、値はその頂点に隣接する頂点と重みのペアのベクターです。
-    std::map<std::string, std::vector<std::pair<std::string, int>>> _data;
+    std::map<std::string, std::vector<std::pair<std::string, Weight>>> _data;
+
+    // 最短経路木に未反映の辺の重みの変更履歴
+    // (木を構築している間だけ記録し、同じ辺の変更は1件にまとめるため、履歴は変更された辺の数より大きくなりません)
+    std::vector<BasicEdgeWeightChange<Weight>> _change_log;
+    // 辺 (小さい方の頂点, 大きい方の頂点) -> _change_log の位置
+    std::map<std::pair<std::string, std::string>, size_t> _change_index;
+
+    // キャッシュした最短経路木 (始点、各頂点への距離と直前の頂点)
+    std::string _tree_source;
+    std::map<std::string, Distance> _tree_distances;
+    std::map<std::string, std::string> _tree_parent;
+
+    // 最後に公開したスナップショット (読み手はアトミックに取得して保持します)
+    std::shared_ptr<const Snapshot> _snapshot;
+    unsigned long _snapshot_version = 0;
+
+    // get_shortest_path で使う CSR 形式の隣接表現 (グラフの変更で作り直します)
+    Csr _csr_cache;
+    bool _csr_dirty = true;
+
+    // CSR を作るときの頂点IDの振り方
+    VertexOrder _vertex_order = VertexOrder::Name;
 
 public:
-    GraphData() {}
+    BasicGraphData() {}
 
     // グラフの内部データを取得します。
-    std::map<std::string, std::vector<std::pair<std::string, int>>> get() {
+    std::map<std::string, std::vector<std::pair<std::string, Weight>>> get() {
         return _data;
     }
 
@@ -35,13 +740,13 @@ public:
 
     // グラフの全辺をベクターとして返します。
     // 無向グラフの場合、(u, v, weight) の形式で返します。
-    std::vector<std::tuple<std::string, std::string, int>> get_edges() {
-        std::set<std::tuple<std::string, std::string, int>> edges;
+    std::vector<std::tuple<std::string, std::string, Weight>> get_edges() {
+        std::set<std::tuple<std::string, std::string, Weight>> edges;
         for (const auto& vertex_pair : _data) {
             const std::string& vertex = vertex_pair.first;
             for (const auto& neighbor_pair : vertex_pair.second) {
                 const std::string& neighbor = neighbor_pair.first;
-                int weight = neighbor_pair.second;
+                Weight weight = neighbor_pair.second;
                 
                 // 辺を正規化して追加（小さい方の頂点を最初にする）
                 std::string edge_first = vertex;
@@ -53,11 +758,11 @@ public:
             }
         }
         
-        return std::vector<std::tuple<std::string, std::string, int>>(edges.begin(), edges.end());
+        return std::vector<std::tuple<std::string, std::string, Weight>>(edges.begin(), edges.end());
     }
 
     // 指定された頂点の隣接ノードと辺の重みのベクターを返します。
-    std::vector<std::pair<std::string, int>> get_neighbors(const std::string& vertex) {
+    std::vector<std::pair<std::string, Weight>> get_neighbors(const std::string& vertex) {
         if (_data.find(vertex) != _data.end()) {
             return _data[vertex];
         } else {
@@ -69,12 +774,13 @@ public:
     bool add_vertex(const std::string& vertex) {
         if (_data.find(vertex) == _data.end()) {
             _data[vertex] = {};
+            _csr_dirty = true;
         }
         return true;
     }
 
     // 両頂点間に辺を追加します。重みを指定します。
-    bool add_edge(const std::string& vertex1, const std::string& vertex2, int weight) {
+    bool add_edge(const std::string& vertex1, const std::string& vertex2, Weight weight) {
         if (_data.find(vertex1) == _data.end()) {
             add_vertex(vertex1);
         }
@@ -84,8 +790,10 @@ public:
         
         // vertex1 -> vertex2 の辺を追加（重み付き）
         bool edge_exists_v1v2 = false;
+        Weight old_weight = Weight();
         for (auto& neighbor_pair : _data[vertex1]) {
             if (neighbor_pair.first == vertex2) {
+                old_weight = neighbor_pair.second;
                 neighbor_pair.second = weight; // 既に存在する場合は重みを更新
                 edge_exists_v1v2 = true;
                 break;
@@ -107,18 +815,118 @@ public:
         if (!edge_exists_v2v1) {
             _data[vertex2].push_back(std::make_pair(vertex1, weight));
         }
-        
+
+        if (!_tree_source.empty()) {
+            // 反映前に同じ辺が変更されていれば、最新の重みだけを書き換える
+            auto key = vertex1 < vertex2 ? std::make_pair(vertex1, vertex2) : std::make_pair(vertex2, vertex1);
+            auto inserted = _change_index.insert(std::make_pair(key, _change_log.size()));
+            if (inserted.second) {
+                _change_log.push_back(BasicEdgeWeightChange<Weight>{vertex1, vertex2, edge_exists_v1v2, old_weight, weight});
+            } else {
+                _change_log[inserted.first->second].new_weight = weight;
+            }
+        }
+        _csr_dirty = true;
         return true;
     }
 
+    // 既存の辺の重みを更新し、最短経路木を構築済みなら変更履歴に記録します。
+    // 辺が存在しない場合は何もせず false を返します。
+    bool update_edge_weight(const std::string& vertex1, const std::string& vertex2, Weight weight) {
+        if (_data.find(vertex1) == _data.end()) {
+            return false;
+        }
+        for (const auto& neighbor_pair : _data[vertex1]) {
+            if (neighbor_pair.first == vertex2) {
+                return add_edge(vertex1, vertex2, weight);
+            }
+        }
+        return false;
+    }
+
+    // 最短経路木にまだ反映していない辺の重みの変更履歴を返します。
+    const std::vector<BasicEdgeWeightChange<Weight>>& get_change_log() const {
+        return _change_log;
+    }
+
     // グラフを空にします。
     bool clear() {
         _data.clear();
+        _csr_dirty = true;
+        _change_log.clear();
+        _change_index.clear();
+        _tree_source.clear();
+        _tree_distances.clear();
+        _tree_parent.clear();
+        return true;
+    }
+
+    // 現在のグラフから新しい版のスナップショットを作成して公開します。
+    // 書き手は1スレッドで辺を追加してから公開し、既存のスナップショットを保持している読み手には影響しません。
+    std::shared_ptr<const Snapshot> publish_snapshot() {
+        auto snapshot = std::make_shared<const Snapshot>(build_csr(), ++_snapshot_version);
+        std::atomic_store(&_snapshot, snapshot);
+        return snapshot;
+    }
+
+    // 最後に公開したスナップショットを取得します。
+    // 読み手のスレッドから書き手と並行して呼び出せます。まだ公開していない場合は nullptr です。
+    std::shared_ptr<const Snapshot> get_snapshot() const {
+        return std::atomic_load(&_snapshot);
+    }
+
+    // 始点から全頂点への最短経路木を計算してキャッシュします。
+    // 以降の辺の重みの変更は、get_tree_path の呼び出し時に差分だけ修復されます。
+    bool build_shortest_path_tree(const std::string& start_vertex) {
+        if (_data.find(start_vertex) == _data.end()) {
+            std::cout << "ERROR: 開始頂点 '" << start_vertex << "' がグラフに存在しません。" << std::endl;
+            return false;
+        }
+        _tree_source = start_vertex;
+        _tree_distances.clear();
+        _tree_parent.clear();
+        for (const auto& vertex_pair : _data) {
+            _tree_distances[vertex_pair.first] = Arithmetic::infinity();
+            _tree_parent[vertex_pair.first] = "";
+        }
+        _tree_distances[start_vertex] = Distance();
+        _change_log.clear();
+        _change_index.clear();
+
+        typedef std::pair<Distance, std::string> PQElement;
+        std::priority_queue<PQElement, std::vector<PQElement>, std::greater<PQElement>> priority_queue;
+        priority_queue.push(std::make_pair(Distance(), start_vertex));
+        propagate_tree(priority_queue);
         return true;
     }
 
+    // キャッシュした最短経路木から、終了頂点への経路と距離を返します。
+    // 木の構築後に変更された辺があれば、先に影響を受ける部分だけを修復します。
+    std::pair<std::vector<std::string>, Distance> get_tree_path(const std::string& end_vertex) {
+        if (_tree_source.empty() || _data.find(end_vertex) == _data.end()) {
+            return std::make_pair(std::vector<std::string>(), Arithmetic::infinity());
+        }
+        repair_shortest_path_tree();
+
+        // 木の構築後に辺なしで追加された頂点は木に含まれず、始点から到達できない
+        auto distance_it = _tree_distances.find(end_vertex);
+        if (distance_it == _tree_distances.end() || distance_it->second == Arithmetic::infinity()) {
+            return std::make_pair(std::vector<std::string>(), Arithmetic::infinity());
+        }
+        // 経路の重みが距離の型の範囲を超えた場合は、経路を返さずにその値を返す
+        if (Arithmetic::is_overflow(distance_it->second)) {
+            return std::make_pair(std::vector<std::string>(), distance_it->second);
+        }
+        std::vector<std::string> path;
+        for (std::string current = end_vertex; !current.empty(); current = _tree_parent[current]) {
+            path.push_back(current);
+        }
+        std::reverse(path.begin(), path.end());
+        return std::make_pair(path, distance_it->second);
+    }
+
     // 最短経路を取得します。
-    std::pair<std::vector<std::string>, double> get_shortest_path(
+    std::pair<std::vector<std::string>, Distance> get_shortest_path(
         const std::string& start_vertex, 
         const std::string& end_vertex, 
         double (*heuristic)(const std::string&, const std::string&)
@@ -126,88 +934,504 @@ public:
         if (_data.find(start_vertex) == _data.end() || _data.find(end_vertex) == _data.end()) {
             std::cout << "ERROR: 開始頂点 '" << start_vertex << "' または 終了頂点 '" 
                       << end_vertex << "' がグラフに存在しません。" << std::endl;
-            return std::make_pair(std::vector<std::string>(), std::numeric_limits<double>::infinity());
+            return std::make_pair(std::vector<std::string>(), Arithmetic::infinity());
         }
 
-        // 距離を初期化: 全ての頂点への距離を無限大に設定し、開始頂点のみ0とする
-        std::map<std::string, double> distances;
-        for (const auto& vertex_pair : _data) {
-            distances[vertex_pair.first] = std::numeric_limits<double>::infinity();
+        // 距離・直前の頂点・優先度付きキューは、スレッドごとの作業領域を使い回す
+        // (全頂点の初期化やメモリ確保は行わない)
+        static thread_local Workspace workspace;
+        auto result = csr_shortest_path(get_csr(), start_vertex, end_vertex, nullptr, workspace);
+
+        // 終了頂点への最短距離が無限大のままなら、到達不可能
+        if (result.second == Arithmetic::infinity()) {
+            std::cout << "INFO: 開始頂点 '" << start_vertex << "' から 終了頂点 '" 
+                      << end_vertex << "' への経路は存在しません。" << std::endl;
+        } else if (Arithmetic::is_overflow(result.second)) {
+            std::cout << "ERROR: 開始頂点 '" << start_vertex << "' から 終了頂点 '" 
+                      << end_vertex << "' への経路の重みが距離の型で表せる範囲を超えました。" << std::endl;
         }
-        distances[start_vertex] = 0;
+        return result;
+    }
+
+    // 最短経路を取得し、探索の統計 (確定した頂点数、緩和した辺の数、キュー操作の回数、
+    // 段階ごとの時間) と一緒に返します。SEARCH_STATS を 0 にすると統計はすべて0になります。
+    BasicSearchResult<Distance> get_shortest_path_with_stats(
+        const std::string& start_vertex, 
+        const std::string& end_vertex, 
+        double (*heuristic)(const std::string&, const std::string&)
+    ) {
+        static thread_local Workspace workspace;
+        BasicSearchResult<Distance> result;
+        auto path_distance = csr_shortest_path(get_csr(), start_vertex, end_vertex, heuristic, workspace, &result.stats);
+        result.path = std::move(path_distance.first);
+        result.distance = path_distance.second;
+        return result;
+    }
 
-        // 経路を記録するための辞書: 各頂点に至る直前の頂点を保持
-        std::map<std::string, std::string> predecessors;
+    // 整数IDの CSR 形式の隣接表現を返します。
+    // グラフが変更されていなければ前回作成したものを再利用します。
+    const Csr& get_csr() {
+        if (_csr_dirty) {
+            _csr_cache = build_csr();
+            _csr_dirty = false;
+        }
+        return _csr_cache;
+    }
+
+    // CSR を作るときの頂点IDの振り方を設定します。
+    // 探索結果の距離は変わりませんが、同じ距離の経路が複数ある場合に選ばれる経路は変わることがあります。
+    void set_vertex_order(VertexOrder order) {
+        if (_vertex_order != order) {
+            _vertex_order = order;
+            _csr_dirty = true;
+        }
+    }
+
+    // 隣接リストを整数IDの CSR 形式に変換します。
+    // 頂点IDは set_vertex_order で設定した順に振ります。
+    Csr build_csr() const {
+        Csr csr;
+        csr.names.reserve(_data.size());
         for (const auto& vertex_pair : _data) {
-            predecessors[vertex_pair.first] = "";
+            csr.index[vertex_pair.first] = static_cast<int>(csr.names.size());
+            csr.names.push_back(vertex_pair.first);
+        }
+        csr.offsets.reserve(_data.size() + 1);
+        csr.offsets.push_back(0);
+        for (const auto& vertex_pair : _data) {
+            for (const auto& neighbor_pair : vertex_pair.second) {
+                csr.targets.push_back(csr.index[neighbor_pair.first]);
+                csr.weights.push_back(neighbor_pair.second);
+            }
+            csr.offsets.push_back(static_cast<int>(csr.targets.size()));
+        }
+        return reorder_csr(csr, _vertex_order);
+    }
+
+    // 隣接リストを圧縮した CSR 形式に変換します (頂点IDの振り方は build_csr と同じです)。
+    BasicCompressedCsrGraph<Weight> build_compressed_csr() const {
+        return compress_csr(build_csr());
+    }
+
+    // 始点から距離 radius 以内の頂点とその距離を、距離の小さい順に返します (始点自身を含みます)。
+    std::vector<std::pair<std::string, Distance>> get_vertices_within_distance(
+        const std::string& start_vertex,
+        Distance radius
+    ) {
+        std::vector<std::pair<std::string, Distance>> vertices;
+        const Csr& csr = get_csr();
+        auto it = csr.index.find(start_vertex);
+        if (it == csr.index.end()) {
+            std::cout << "ERROR: 開始頂点 '" << start_vertex << "' がグラフに存在しません。" << std::endl;
+            return vertices;
+        }
+        static thread_local Workspace workspace;
+        static thread_local std::vector<std::pair<int, Distance>> found;
+        found.clear();
+        csr_bounded_search(csr, it->second, radius, workspace, found);
+        vertices.reserve(found.size());
+        for (const auto& vertex_distance : found) {
+            vertices.push_back(std::make_pair(csr.names[vertex_distance.first], vertex_distance.second));
         }
+        return vertices;
+    }
 
-        // 優先度付きキュー: (距離, 頂点) のペアを格納し、距離が小さい順に取り出す
-        // C++の優先度付きキューはデフォルトで最大ヒープなので、距離にマイナスを付けるか比較関数を反転する
-        typedef std::pair<double, std::string> PQElement;
-        std::priority_queue<PQElement, std::vector<PQElement>, std::greater<PQElement>> priority_queue;
-        
-        priority_queue.push(std::make_pair(0.0, start_vertex));
+    // 複数の始点について get_vertices_within_distance をまとめて計算します。
+    // 始点は num_threads 個のスレッドに分配されます (0 の場合はハードウェアの並列数)。
+    // 結果は sources と同じ順に並び、グラフに存在しない始点の結果は空になります。
+    std::vector<std::vector<std::pair<std::string, Distance>>> get_vertices_within_distance(
+        const std::vector<std::string>& sources,
+        Distance radius,
+        unsigned int num_threads = 0
+    ) {
+        std::vector<std::vector<std::pair<std::string, Distance>>> results(sources.size());
+        if (sources.empty()) {
+            return results;
+        }
+        const Csr& csr = get_csr();
 
-        while (!priority_queue.empty()) {
-            // 優先度付きキューから最も距離の小さい頂点を取り出す
-            double current_distance = priority_queue.top().first;
-            std::string current_vertex = priority_queue.top().second;
-            priority_queue.pop();
+        if (num_threads == 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        num_threads = static_cast<unsigned int>(std::min<size_t>(num_threads, sources.size()));
 
-            // 取り出した頂点への距離が、すでに記録されている距離より大きい場合は、
-            // より短い経路が既に見つかっているためスキップ
-            if (current_distance > distances[current_vertex]) {
-                continue;
+        // 各スレッドは次に処理する始点の番号を共有カウンタから取り出す
+        std::atomic<size_t> next_source(0);
+        auto worker = [&]() {
+            Workspace workspace;
+            std::vector<std::pair<int, Distance>> found;
+            for (size_t i = next_source++; i < sources.size(); i = next_source++) {
+                auto it = csr.index.find(sources[i]);
+                if (it == csr.index.end()) {
+                    continue;
+                }
+                found.clear();
+                csr_bounded_search(csr, it->second, radius, workspace, found);
+                results[i].reserve(found.size());
+                for (const auto& vertex_distance : found) {
+                    results[i].push_back(std::make_pair(csr.names[vertex_distance.first], vertex_distance.second));
+                }
             }
+        };
+        std::vector<std::thread> threads;
+        for (unsigned int t = 1; t < num_threads; ++t) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return results;
+    }
 
-            // 終了頂点に到達したら探索終了
-            if (current_vertex == end_vertex) {
-                break; // 最短経路が見つかった
+    // 多対多の最短距離表を計算します。
+    // 始点ごとに1回だけ距離の上限なしの csr_bounded_search を実行し、すべての終点が確定した時点で打ち切ります。
+    // 結果は sources.size() x targets.size() の行優先の連続した配列 (table[i * targets.size() + j]) に格納します。
+    // 始点は num_threads 個のスレッドに分配されます (0 の場合はハードウェアの並列数)。
+    // 到達不可能、またはグラフに存在しない頂点の組の距離は無限大になります。
+    std::vector<Distance> get_distance_table(
+        const std::vector<std::string>& sources,
+        const std::vector<std::string>& targets,
+        unsigned int num_threads = 0
+    ) {
+        const Distance infinity = Arithmetic::infinity();
+        const size_t num_targets = targets.size();
+        std::vector<Distance> table(sources.size() * num_targets, infinity);
+        if (sources.empty() || num_targets == 0) {
+            return table;
+        }
+
+        const Csr& csr = get_csr();
+
+        // 終点の頂点IDと、各頂点が何個の終点に対応するかを求める
+        std::vector<int> target_ids(num_targets, -1);
+        std::vector<int> target_count(csr.num_vertices(), 0);
+        int num_distinct_targets = 0;
+        for (size_t j = 0; j < num_targets; ++j) {
+            auto it = csr.index.find(targets[j]);
+            if (it != csr.index.end()) {
+                target_ids[j] = it->second;
+                if (target_count[it->second]++ == 0) {
+                    ++num_distinct_targets;
+                }
             }
+        }
+        if (num_distinct_targets == 0) {
+            return table;
+        }
 
-            // 現在の頂点から到達可能な隣接頂点を探索
-            for (const auto& neighbor_pair : get_neighbors(current_vertex)) {
-                const std::string& neighbor = neighbor_pair.first;
-                int weight = neighbor_pair.second;
-                double distance_through_current = distances[current_vertex] + weight;
-
-                // より短い経路が見つかった場合
-                if (distance_through_current < distances[neighbor]) {
-                    distances[neighbor] = distance_through_current;
-                    predecessors[neighbor] = current_vertex;
-                    // 優先度付きキューに隣接頂点を追加または更新
-                    // ダイクストラ法では heuristic は使用しない (または h=0)
-                    priority_queue.push(std::make_pair(distance_through_current, neighbor));
+        if (num_threads == 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        num_threads = static_cast<unsigned int>(std::min<size_t>(num_threads, sources.size()));
+
+        // 各スレッドは次に処理する始点の番号を共有カウンタから取り出す
+        std::atomic<size_t> next_source(0);
+        auto worker = [&]() {
+            // 作業領域はスレッドごとに1つ用意し、始点が変わっても O(1) で初期化して使い回す
+            Workspace workspace;
+            for (size_t i = next_source++; i < sources.size(); i = next_source++) {
+                auto it = csr.index.find(sources[i]);
+                if (it == csr.index.end()) {
+                    continue;
+                }
+                // 確定した頂点は1回だけ通知されるため、終点の種類の数だけ数えれば打ち切れる
+                int remaining_targets = num_distinct_targets;
+                csr_bounded_search(csr, it->second, infinity, workspace, [&](int vertex, Distance) {
+                    return target_count[vertex] == 0 || --remaining_targets > 0;
+                });
+
+                Distance* row = table.data() + i * num_targets;
+                for (size_t j = 0; j < num_targets; ++j) {
+                    if (target_ids[j] >= 0) {
+                        row[j] = workspace.distance(target_ids[j]);
+                    }
                 }
             }
+        };
+        std::vector<std::thread> threads;
+        for (unsigned int t = 1; t < num_threads; ++t) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
         }
+        return table;
+    }
 
-        // 終了頂点への最短距離が無限大のままなら、到達不可能
-        if (distances[end_vertex] == std::numeric_limits<double>::infinity()) {
-            std::cout << "INFO: 開始頂点 '" << start_vertex << "' から 終了頂点 '" 
-                      << end_vertex << "' への経路は存在しません。" << std::endl;
-            return std::make_pair(std::vector<std::string>(), std::numeric_limits<double>::infinity());
+    // Yen のアルゴリズムで、始点から終点への単純経路 (ループなし) を短い順に最大 k 本返します。
+    // スパー経路の探索ではグラフを複製せず、キャッシュした CSR 上で頂点・辺を除外して csr_shortest_path を呼び出し、
+    // 最初に終点から求めた各頂点の距離を下界とする A* で終点に向かう頂点だけを調べます。
+    // 候補が k 本そろった後は、k 番目の候補より長くなるスパー経路の探索を途中で打ち切ります。
+    // 重みが距離の型の範囲を超えた経路の重みは、Arithmetic::is_overflow で判定できる値になります。
+    std::vector<std::pair<std::vector<std::string>, Distance>> get_k_shortest_paths(
+        const std::string& start_vertex,
+        const std::string& end_vertex,
+        size_t k
+    ) {
+        std::vector<std::pair<std::vector<std::string>, Distance>> result;
+        if (_data.find(start_vertex) == _data.end() || _data.find(end_vertex) == _data.end()) {
+            std::cout << "ERROR: 開始頂点 '" << start_vertex << "' または 終了頂点 '" 
+                      << end_vertex << "' がグラフに存在しません。" << std::endl;
+            return result;
+        }
+        if (k == 0) {
+            return result;
         }
 
-        // 最短経路を再構築
-        std::vector<std::string> path;
-        std::string current = end_vertex;
-        while (!current.empty()) {
-            path.push_back(current);
-            current = predecessors[current];
+        const Distance infinity = Arithmetic::infinity();
+        const Csr& csr = get_csr();
+        const int source = csr.index.at(start_vertex);
+        const int target = csr.index.at(end_vertex);
+
+        // 作業領域と頂点のマスクはスレッドごとに使い回す (マスクは呼び出しの終わりにすべて0に戻る)
+        static thread_local Workspace workspace;
+        static thread_local std::vector<char> vertex_blocked;
+        if (vertex_blocked.size() < static_cast<size_t>(csr.num_vertices())) {
+            vertex_blocked.resize(csr.num_vertices(), 0);
         }
-        std::reverse(path.begin(), path.end()); // 経路は逆順に構築されたので反転
 
-        // 開始ノードから開始されていることを確認
-        if (path[0] != start_vertex) {
-            return std::make_pair(std::vector<std::string>(), std::numeric_limits<double>::infinity());
+        // スパー頂点から出る辺のうち、取り除く辺の行き先
+        int spur_vertex = -1;
+        std::vector<int> blocked_next;
+        auto allow_edge = [&](int u, int v) {
+            return !vertex_blocked[v] &&
+                   (u != spur_vertex || std::find(blocked_next.begin(), blocked_next.end(), v) == blocked_next.end());
+        };
+        // 辺は両方向に張られているため、終点からの距離がそのまま各頂点から終点までの距離になる。
+        // 辺を取り除いても距離は短くならないので、すべてのスパー探索で A* の下界として使える
+        static thread_local Workspace to_target;
+        csr_bounded_search(csr, target, infinity, to_target, [](int, Distance) {
+            return true;
+        });
+        auto estimate = [](int vertex) {
+            return to_target.distance(vertex);
+        };
+        auto edge_weight = [&csr](int u, int v) {
+            Weight edge_weight = Weight();
+            csr.for_each_edge(u, [&](int neighbor, Weight weight) {
+                if (neighbor == v) {
+                    edge_weight = weight;
+                }
+            });
+            return edge_weight;
+        };
+        // 作業領域に残った直前の頂点から、from から target への経路を取り出します。
+        auto extract_path = [&](int from, std::vector<int>& path) {
+            path.clear();
+            for (int v = target; v != from; v = workspace.predecessor(v)) {
+                path.push_back(v);
+            }
+            path.push_back(from);
+            std::reverse(path.begin(), path.end());
+        };
+
+        // 確定した経路 A と候補経路 B (重み, 頂点IDの列)
+        // B には確定済みの経路を入れず、選ばれる可能性のある短い方から k - A の本数だけを残す
+        std::vector<std::vector<int>> found_paths;
+        std::vector<Distance> found_costs;
+        std::set<std::pair<Distance, std::vector<int>>> candidates;
+
+        std::vector<int> path;
+        Distance cost = csr_shortest_path(csr, source, target, estimate, AllEdges(), infinity, workspace);
+        if (cost == infinity) {
+            return result;
+        }
+        extract_path(source, path);
+        found_paths.push_back(path);
+        found_costs.push_back(cost);
+
+        std::vector<int> spur_path;
+        std::vector<size_t> common_prefix; // 各確定経路と直前の経路が共有する先頭頂点数
+        while (found_paths.size() < k) {
+            const std::vector<int>& previous = found_paths.back();
+            const size_t needed = k - found_paths.size();
+
+            // ルート経路が一致する確定経路はスパー頂点ごとに調べ直さず、共通接頭辞の長さから判定する
+            common_prefix.assign(found_paths.size(), 0);
+            for (size_t j = 0; j < found_paths.size(); ++j) {
+                const std::vector<int>& other = found_paths[j];
+                size_t length = 0;
+                while (length < other.size() && length < previous.size() && other[length] == previous[length]) {
+                    ++length;
+                }
+                common_prefix[j] = length;
+            }
+
+            Distance root_cost = Distance(); // ルート経路の重みは接頭辞ごとに累積して再計算を避ける
+            for (size_t i = 0; i + 1 < previous.size(); ++i) {
+                spur_vertex = previous[i];
+
+                // ルート経路を共有する確定経路の次の辺を取り除く
+                // (スパー経路はスパー頂点に戻らないため、逆向きの辺は取り除かなくてよい)
+                blocked_next.clear();
+                for (size_t j = 0; j < found_paths.size(); ++j) {
+                    if (common_prefix[j] >= i + 1 && found_paths[j].size() > i + 1) {
+                        blocked_next.push_back(found_paths[j][i + 1]);
+                    }
+                }
+
+                // 候補が必要な本数そろっていれば、最後の候補より長い経路は選ばれない
+                // (ルート経路だけで最後の候補より長ければ、スパー経路は探さない)
+                Distance spur_cost = infinity;
+                const bool enough = candidates.size() >= needed;
+                if (!enough || !(std::prev(candidates.end())->first < root_cost)) {
+                    const Distance bound = enough ? static_cast<Distance>(std::prev(candidates.end())->first - root_cost)
+                                                  : infinity;
+                    spur_cost = csr_shortest_path(csr, spur_vertex, target, estimate, allow_edge, bound, workspace);
+                }
+                if (spur_cost != infinity) {
+                    extract_path(spur_vertex, spur_path);
+                    std::vector<int> total_path(previous.begin(), previous.begin() + i);
+                    total_path.insert(total_path.end(), spur_path.begin(), spur_path.end());
+                    if (std::find(found_paths.begin(), found_paths.end(), total_path) == found_paths.end()) {
+                        candidates.insert(std::make_pair(Arithmetic::add(root_cost, spur_cost), total_path));
+                        if (candidates.size() > needed) {
+                            candidates.erase(std::prev(candidates.end()));
+                        }
+                    }
+                }
+
+                // スパー頂点は次のルート経路の一部になるため、以降の探索から除外する
+                vertex_blocked[spur_vertex] = 1;
+                root_cost = Arithmetic::add(root_cost, edge_weight(spur_vertex, previous[i + 1]));
+            }
+            for (size_t i = 0; i + 1 < previous.size(); ++i) {
+                vertex_blocked[previous[i]] = 0;
+            }
+
+            if (candidates.empty()) {
+                break;
+            }
+            found_costs.push_back(candidates.begin()->first);
+            found_paths.push_back(candidates.begin()->second);
+            candidates.erase(candidates.begin());
         }
 
-        return std::make_pair(path, distances[end_vertex]);
+        for (size_t j = 0; j < found_paths.size(); ++j) {
+            std::vector<std::string> named_path;
+            for (int v : found_paths[j]) {
+                named_path.push_back(csr.names[v]);
+            }
+            result.push_back(std::make_pair(named_path, found_costs[j]));
+        }
+        return result;
+    }
+
+private:
+    // 優先度付きキューに積まれた頂点から、最短経路木の距離を緩和して広げます。
+    void propagate_tree(std::priority_queue<std::pair<Distance, std::string>,
+                                            std::vector<std::pair<Distance, std::string>>,
+                                            std::greater<std::pair<Distance, std::string>>>& priority_queue) {
+        while (!priority_queue.empty()) {
+            Distance current_distance = priority_queue.top().first;
+            std::string current_vertex = priority_queue.top().second;
+            priority_queue.pop();
+            if (current_distance > _tree_distances[current_vertex]) {
+                continue;
+            }
+            for (const auto& neighbor_pair : _data[current_vertex]) {
+                Distance distance_through_current = Arithmetic::add(current_distance, neighbor_pair.second);
+                if (distance_through_current < _tree_distances[neighbor_pair.first]) {
+                    _tree_distances[neighbor_pair.first] = distance_through_current;
+                    _tree_parent[neighbor_pair.first] = current_vertex;
+                    priority_queue.push(std::make_pair(distance_through_current, neighbor_pair.first));
+                }
+            }
+        }
+    }
+
+    // 未反映の変更履歴を1件ずつ最短経路木に反映し、反映した履歴を取り除きます (動的単一始点最短経路)。
+    // - 重みが減った辺: 短くなった側の頂点から先だけを再緩和します。
+    // - 木に含まれる辺の重みが増えた: その辺より下の部分木だけを無効化し、
+    //   部分木の外側の頂点から距離を求め直します。
+    // - 木に含まれない辺の重みが増えた: 最短経路は変わらないため何もしません。
+    // 変更された辺が頂点数より多い場合は、差分を修復するより木全体を作り直します。
+    void repair_shortest_path_tree() {
+        if (_change_log.size() > _tree_distances.size()) {
+            const std::string source = _tree_source;
+            build_shortest_path_tree(source);
+            return;
+        }
+        const Distance infinity = Arithmetic::infinity();
+        typedef std::pair<Distance, std::string> PQElement;
+        // 木の構築後に追加された頂点は、他の変更の修復で先に届く場合があるため最初にまとめて登録する
+        for (const BasicEdgeWeightChange<Weight>& change : _change_log) {
+            for (const std::string* vertex : {&change.vertex1, &change.vertex2}) {
+                if (_tree_distances.find(*vertex) == _tree_distances.end()) {
+                    _tree_distances[*vertex] = infinity;
+                    _tree_parent[*vertex] = "";
+                }
+            }
+        }
+        for (const BasicEdgeWeightChange<Weight>& change : _change_log) {
+            std::priority_queue<PQElement, std::vector<PQElement>, std::greater<PQElement>> priority_queue;
+            if (!change.existed || change.new_weight < change.old_weight) {
+                for (int direction = 0; direction < 2; ++direction) {
+                    const std::string& u = direction == 0 ? change.vertex1 : change.vertex2;
+                    const std::string& v = direction == 0 ? change.vertex2 : change.vertex1;
+                    const Distance distance_through_u = Arithmetic::add(_tree_distances[u], change.new_weight);
+                    if (distance_through_u < _tree_distances[v]) {
+                        _tree_distances[v] = distance_through_u;
+                        _tree_parent[v] = u;
+                        priority_queue.push(std::make_pair(_tree_distances[v], v));
+                    }
+                }
+                propagate_tree(priority_queue);
+                continue;
+            }
+
+            // 重みが増えた辺が木の辺でなければ何もしない
+            std::string child;
+            if (_tree_parent[change.vertex2] == change.vertex1) {
+                child = change.vertex2;
+            } else if (_tree_parent[change.vertex1] == change.vertex2) {
+                child = change.vertex1;
+            } else {
+                continue;
+            }
+
+            // child を根とする部分木を集めて無効化する (子は隣接頂点のうち親が自分のもの)
+            std::vector<std::string> subtree = {child};
+            std::set<std::string> in_subtree = {child};
+            for (size_t i = 0; i < subtree.size(); ++i) {
+                for (const auto& neighbor_pair : _data[subtree[i]]) {
+                    if (_tree_parent[neighbor_pair.first] == subtree[i] && in_subtree.insert(neighbor_pair.first).second) {
+                        subtree.push_back(neighbor_pair.first);
+                    }
+                }
+            }
+            for (const std::string& vertex : subtree) {
+                _tree_distances[vertex] = infinity;
+                _tree_parent[vertex] = "";
+            }
+
+            // 部分木の各頂点について、部分木の外側の隣接頂点を経由する最良の距離を初期値にする
+            for (const std::string& vertex : subtree) {
+                for (const auto& neighbor_pair : _data[vertex]) {
+                    if (in_subtree.count(neighbor_pair.first) == 0) {
+                        const Distance distance_through_neighbor =
+                            Arithmetic::add(_tree_distances[neighbor_pair.first], neighbor_pair.second);
+                        if (distance_through_neighbor < _tree_distances[vertex]) {
+                            _tree_distances[vertex] = distance_through_neighbor;
+                            _tree_parent[vertex] = neighbor_pair.first;
+                        }
+                    }
+                }
+                if (_tree_distances[vertex] != infinity) {
+                    priority_queue.push(std::make_pair(_tree_distances[vertex], vertex));
+                }
+            }
+            propagate_tree(priority_queue);
+        }
+        _change_log.clear();
+        _change_index.clear();
     }
 };
 
+typedef BasicGraphData<int, double> GraphData;
+
 // ヒューリスティック関数 (この例では常に0、ダイクストラ法と同じ)
 double dummy_heuristic(const std::string& u, const std::string& v) {
     // u と v の間に何らかの推定距離を計算する関数
@@ -335,6 +1559,159 @@ int main() {
     print_vector(shortest_path.first);
     std::cout << " (重み: " << shortest_path.second << ")" << std::endl;
 
+    graph_data.clear();
+    inputList = {
+        std::make_tuple("A", "B", 4), 
+        std::make_tuple("B", "C", 3), 
+        std::make_tuple("B", "D", 2), 
+        std::make_tuple("D", "A", 1), 
+        std::make_tuple("A", "C", 2), 
+        std::make_tuple("E", "F", 1)
+    };
+    for (const auto& input : inputList) {
+        graph_data.add_edge(std::get<0>(input), std::get<1>(input), std::get<2>(input));
+    }
+    std::vector<std::string> sources = {"A", "D", "E"};
+    std::vector<std::string> targets = {"B", "C", "F", "X"};
+    std::vector<double> table = graph_data.get_distance_table(sources, targets);
+    std::cout << "\n距離表 (始点 ";
+    print_vector(sources);
+    std::cout << " x 終点 ";
+    print_vector(targets);
+    std::cout << "):" << std::endl;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        std::cout << "  " << sources[i] << ": ";
+        print_vector(std::vector<double>(table.begin() + i * targets.size(), table.begin() + (i + 1) * targets.size()));
+        std::cout << std::endl;
+    }
+
+    input = std::make_pair("A", "C");
+    auto k_shortest_paths = graph_data.get_k_shortest_paths(input.first, input.second, 3);
+    std::cout << "\n経路" << input.first << "-" << input.second << " の短い順の経路 (k=3):" << std::endl;
+    for (const auto& path_cost : k_shortest_paths) {
+        std::cout << "  ";
+        print_vector(path_cost.first);
+        std::cout << " (重み: " << path_cost.second << ")" << std::endl;
+    }
+
+    graph_data.build_shortest_path_tree("A");
+    std::vector<std::tuple<std::string, std::string, int>> updates = {
+        std::make_tuple("A", "C", 9), 
+        std::make_tuple("B", "D", 1), 
+        std::make_tuple("E", "F", 3)
+    };
+    for (const auto& update : updates) {
+        graph_data.update_edge_weight(std::get<0>(update), std::get<1>(update), std::get<2>(update));
+        auto tree_path = graph_data.get_tree_path("C");
+        std::cout << "\n辺 " << std::get<0>(update) << "-" << std::get<1>(update) << " の重みを "
+                  << std::get<2>(update) << " に更新後、経路A-C の最短経路は ";
+        print_vector(tree_path.first);
+        std::cout << " (重み: " << tree_path.second << ")" << std::endl;
+    }
+    std::cout << "未反映の変更履歴の件数: " << graph_data.get_change_log().size() << std::endl;
+
+    // 読み手のスレッドはスナップショットに対して探索し、その間に書き手が辺を追加して新しい版を公開する
+    graph_data.publish_snapshot();
+    std::vector<std::pair<unsigned long, std::pair<std::vector<std::string>, double>>> snapshot_results(4);
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < snapshot_results.size(); ++i) {
+        readers.emplace_back([&graph_data, &snapshot_results, i]() {
+            std::shared_ptr<const GraphSnapshot> snapshot = graph_data.get_snapshot();
+            snapshot_results[i] = std::make_pair(snapshot->get_version(),
+                                                 snapshot->get_shortest_path("A", "F", dummy_heuristic));
+        });
+    }
+    graph_data.add_edge("C", "E", 2);
+    graph_data.publish_snapshot();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    // 各読み手の結果は、取得した版のグラフに対して一貫している (版1では経路なし、版2では経路あり)
+    for (size_t i = 0; i < snapshot_results.size(); ++i) {
+        bool consistent = (snapshot_results[i].first == 1) == snapshot_results[i].second.first.empty();
+        std::cout << "\n読み手" << i << " の結果は取得した版と" << (consistent ? "一貫しています" : "矛盾しています");
+    }
+    auto latest_path = graph_data.get_snapshot()->get_shortest_path("A", "F", dummy_heuristic);
+    std::cout << "\n最新の版 " << graph_data.get_snapshot()->get_version() << " の経路A-F の最短経路は ";
+    print_vector(latest_path.first);
+    std::cout << " (重み: " << latest_path.second << ")" << std::endl;
+
+    // 探索の統計は探索ごとに返され、複数の探索の分を合計できる
+    SearchStats total_stats;
+    for (const auto& query : std::vector<std::pair<std::string, std::string>>{{"A", "F"}, {"B", "E"}, {"D", "C"}}) {
+        SearchResult result = graph_data.get_shortest_path_with_stats(query.first, query.second, dummy_heuristic);
+        std::cout << "\n経路" << query.first << "-" << query.second << ": 確定 " << result.stats.settled
+                  << ", 緩和 " << result.stats.relaxed << ", 追加 " << result.stats.heap_pushes
+                  << ", 取り出し " << result.stats.heap_pops << " (古い情報 " << result.stats.stale_pops << ")";
+        total_stats += result.stats;
+    }
+    std::cout << "\n合計 (" << total_stats.queries << " 回の探索): 確定 " << total_stats.settled
+              << ", 緩和 " << total_stats.relaxed << std::endl;
+
+    // 頂点IDの振り方を変えても最短距離は変わらない
+    const std::vector<std::pair<VertexOrder, std::string>> orders = {
+        {VertexOrder::Name, "頂点名順"}, {VertexOrder::Bfs, "幅優先順"},
+        {VertexOrder::Rcm, "RCM順"}, {VertexOrder::Degree, "次数順"}
+    };
+    for (const auto& order : orders) {
+        graph_data.set_vertex_order(order.first);
+        const CsrGraph& csr = graph_data.get_csr();
+        std::cout << "\n" << order.second << " のID: ";
+        print_vector(csr.names);
+        auto ordered_path = graph_data.get_shortest_path("A", "F", dummy_heuristic);
+        std::cout << ", 経路A-F の重み: " << ordered_path.second;
+    }
+    graph_data.set_vertex_order(VertexOrder::Name);
+    std::cout << std::endl;
+
+    // 圧縮した隣接表現でも同じ最短経路が得られる
+    CompressedCsrGraph compressed = graph_data.build_compressed_csr();
+    SearchWorkspace compressed_workspace;
+    auto compressed_path = csr_shortest_path(compressed, "A", "F", dummy_heuristic, compressed_workspace);
+    std::cout << "\n圧縮した隣接表現での経路A-F の最短経路は ";
+    print_vector(compressed_path.first);
+    std::cout << " (重み: " << compressed_path.second << ")";
+    std::cout << "\n隣接表現のメモリ: " << graph_data.get_csr().memory_bytes() << " バイト -> "
+              << compressed.memory_bytes() << " バイト" << std::endl;
+
+    // 重みを unsigned short、距離を unsigned int にした隣接表現でも同じ最短経路が得られる
+    BasicCsrGraph<unsigned short> compact;
+    if (convert_csr_weights(graph_data.get_csr(), compact)) {
+        BasicSearchWorkspace<unsigned int> compact_workspace;
+        auto compact_path = csr_shortest_path(compact, "A", "F", dummy_heuristic, compact_workspace);
+        std::cout << "\nunsigned short の重みでの経路A-F の最短経路は ";
+        print_vector(compact_path.first);
+        std::cout << " (重み: " << compact_path.second << ")";
+        std::cout << "\n隣接表現のメモリ: " << graph_data.get_csr().memory_bytes() << " バイト -> "
+                  << compact.memory_bytes() << " バイト" << std::endl;
+    }
+
+    // 距離が型の範囲を超える場合は、誤った有限の距離ではなく範囲を超えたことが結果でわかる
+    BasicSearchWorkspace<unsigned short> overflow_workspace;
+    BasicCsrGraph<unsigned short> heavy = compact;
+    std::fill(heavy.weights.begin(), heavy.weights.end(), static_cast<unsigned short>(40000));
+    auto overflow_path = csr_shortest_path(heavy, "A", "F", dummy_heuristic, overflow_workspace);
+    std::cout << "重み 40000 の辺での経路A-F (unsigned short の距離) は ";
+    if (CheckedArithmetic<unsigned short>::is_overflow(overflow_path.second)) {
+        std::cout << "距離が unsigned short の範囲を超えました。" << std::endl;
+    } else {
+        print_vector(overflow_path.first);
+        std::cout << " (重み: " << overflow_path.second << ")" << std::endl;
+    }
+
+    // 距離の上限付きの探索
+    auto nearby = graph_data.get_vertices_within_distance("A", 5);
+    std::cout << "\nA から距離5以内の頂点: ";
+    for (const auto& vertex_distance : nearby) {
+        std::cout << vertex_distance.first << "(" << vertex_distance.second << ") ";
+    }
+    auto nearby_batch = graph_data.get_vertices_within_distance(std::vector<std::string>{"A", "F", "Z"}, 3);
+    std::cout << "\n距離3以内の頂点の数 (A, F, Z): ";
+    for (const auto& vertices : nearby_batch) {
+        std::cout << vertices.size() << " ";
+    }
+    std::cout << std::endl;
+
     std::cout << "\nDijkstra <----- end" << std::endl;
 
     return 0;
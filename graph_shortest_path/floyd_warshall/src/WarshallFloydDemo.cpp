@@ -9,17 +9,24 @@
 #include <algorithm>
 #include <utility>
 #include <string>
+#include <type_traits>
 
-class GraphData {
+#include "../../common/src/CheckedArithmetic.h"
+
+// 辺の重みの型 Weight と距離の型 Distance を指定できるグラフです。
+// 距離行列は Distance で保持するため、例えば BasicGraphData<int> は double の半分のメモリで済みます。
+// 距離の加算と無限大は Arithmetic (既定は CheckedArithmetic) に従います。
+template <typename Weight, typename Distance = Weight, typename Arithmetic = CheckedArithmetic<Distance>>
+class BasicGraphData {
 private:
     // 隣接ノードとその辺の重みを格納します。
     // キーは頂点、値はその頂点に隣接する頂点と重みのペアのベクターです。
-    std::unordered_map<std::string, std::vector<std::pair<std::string, double>>> _data;
+    std::unordered_map<std::string, std::vector<std::pair<std::string, Weight>>> _data;
 
 public:
-    GraphData() {}
+    BasicGraphData() {}
 
-    const std::unordered_map<std::string, std::vector<std::pair<std::string, double>>>& get() const {
+    const std::unordered_map<std::string, std::vector<std::pair<std::string, Weight>>>& get() const {
         // グラフの内部データを取得します。
         return _data;
     }
@@ -33,16 +40,16 @@ public:
         return vertices;
     }
 
-    std::vector<std::tuple<std::string, std::string, double>> get_edges() const {
+    std::vector<std::tuple<std::string, std::string, Weight>> get_edges() const {
         // グラフの全辺をベクターとして返します。
         // 無向グラフの場合、(u, v, weight) の形式で返します。
         // 重複を避けるためにセットを使用します。
-        std::set<std::tuple<std::string, std::string, double>> edges;
+        std::set<std::tuple<std::string, std::string, Weight>> edges;
         for (const auto& vertex_pair : _data) {
             const std::string& vertex = vertex_pair.first;
             for (const auto& neighbor_weight : vertex_pair.second) {
                 const std::string& neighbor = neighbor_weight.first;
-                double weight = neighbor_weight.second;
+                Weight weight = neighbor_weight.second;
                 
                 // 辺を正規化してセットに追加 (小さい方の頂点を最初にするなど)
                 std::string v1 = vertex;
@@ -53,10 +60,10 @@ public:
                 edges.insert(std::make_tuple(v1, v2, weight));
             }
         }
-        return std::vector<std::tuple<std::string, std::string, double>>(edges.begin(), edges.end());
+        return std::vector<std::tuple<std::string, std::string, Weight>>(edges.begin(), edges.end());
     }
 
-    std::vector<std::pair<std::string, double>> get_neighbors(const std::string& vertex) const {
+    std::vector<std::pair<std::string, Weight>> get_neighbors(const std::string& vertex) const {
         // 指定された頂点の隣接ノードと辺の重みのベクターを返します。
         // 形式: [(隣接頂点, 重み), ...]
         auto it = _data.find(vertex);
@@ -77,7 +84,7 @@ public:
         return true;
     }
 
-    bool add_edge(const std::string& vertex1, const std::string& vertex2, double weight) {
+    bool add_edge(const std::string& vertex1, const std::string& vertex2, Weight weight) {
         // 両頂点間に辺を追加します。重みを指定します。
         // 頂点がグラフに存在しない場合は追加します。
         if (_data.find(vertex1) == _data.end()) {
@@ -122,15 +129,15 @@ public:
         return true;
     }
 
-    std::pair<std::vector<std::string>, double> get_shortest_path(
+    std::pair<std::vector<std::string>, Distance> get_shortest_path(
         const std::string& start_vertex, 
         const std::string& end_vertex, 
-        double (*heuristic)(const std::string&, const std::string&)) {
+        Distance (*heuristic)(const std::string&, const std::string&)) {
         
         std::vector<std::string> vertices = get_vertices();
         size_t num_vertices = vertices.size();
         if (num_vertices == 0) {
-            return {std::vector<std::string>(), std::numeric_limits<double>::infinity()};
+            return {std::vector<std::string>(), Arithmetic::infinity()};
         }
 
         // 頂点名をインデックスにマッピング
@@ -145,15 +152,15 @@ public:
         if (vertex_to_index.find(start_vertex) == vertex_to_index.end() || 
             vertex_to_index.find(end_vertex) == vertex_to_index.end()) {
             std::cout << "ERROR: " << start_vertex << " または " << end_vertex << " がグラフに存在しません。" << std::endl;
-            return {std::vector<std::string>(), std::numeric_limits<double>::infinity()};
+            return {std::vector<std::string>(), Arithmetic::infinity()};
         }
 
         size_t start_index = vertex_to_index[start_vertex];
         size_t end_index = vertex_to_index[end_vertex];
 
         // 距離行列 (dist) と経路復元用行列 (next_node) を初期化
-        const double INF = std::numeric_limits<double>::infinity();
-        std::vector<std::vector<double>> dist(num_vertices, std::vector<double>(num_vertices, INF));
+        const Distance INF = Arithmetic::infinity();
+        std::vector<std::vector<Distance>> dist(num_vertices, std::vector<Distance>(num_vertices, INF));
         std::vector<std::vector<size_t>> next_node(num_vertices, std::vector<size_t>(num_vertices));
         // nextを初期化（インデックスとして有効な値以外で初期化）
         for (size_t i = 0; i < num_vertices; ++i) {
@@ -164,13 +171,13 @@ public:
 
         // 初期距離と経路復元情報を設定
         for (size_t i = 0; i < num_vertices; ++i) {
-            dist[i][i] = 0; // 自分自身への距離は0
+            dist[i][i] = Distance(); // 自分自身への距離は0
             const std::string& vertex_i = vertices[i];
             for (const auto& neighbor_weight : get_neighbors(vertex_i)) {
                 const std::string& neighbor = neighbor_weight.first;
-                double weight = neighbor_weight.second;
+                Weight weight = neighbor_weight.second;
                 size_t j = vertex_to_index[neighbor];
-                dist[i][j] = weight;
+                dist[i][j] = Arithmetic::add(Distance(), weight); // 重みが距離の型で表せない場合は範囲外の値になる
                 next_node[i][j] = j; // iからjへの直接辺の場合、iの次はj
             }
         }
@@ -183,8 +190,10 @@ public:
                 // j: 終了頂点のインデックス
                 for (size_t j = 0; j < num_vertices; ++j) {
                     // i -> k -> j の経路が i -> j の現在の経路より短い場合
-                    if (dist[i][k] != INF && dist[k][j] != INF && dist[i][k] + dist[k][j] < dist[i][j]) {
-                        dist[i][j] = dist[i][k] + dist[k][j];
+                    // (どちらかが無限大なら和も無限大になるため、更新されない)
+                    Distance through_k = Arithmetic::add(dist[i][k], dist[k][j]);
+                    if (through_k < dist[i][j]) {
+                        dist[i][j] = through_k;
                         next_node[i][j] = next_node[i][k]; // iからjへの最短経路で、iの次の頂点はiからkへの最短経路でのiの次の頂点
                     }
                 }
@@ -192,13 +201,20 @@ public:
         }
 
         // 指定された開始・終了頂点間の最短経路と重みを取得
-        double shortest_distance = dist[start_index][end_index];
+        Distance shortest_distance = dist[start_index][end_index];
 
         // 経路が存在しない場合 (距離がINF)
         if (shortest_distance == INF) {
             return {std::vector<std::string>(), INF};
         }
 
+        // 経路の重みが距離の型の範囲を超えた場合は、誤った距離を返さずにエラーにする
+        if (Arithmetic::is_overflow(shortest_distance)) {
+            std::cout << "ERROR: " << start_vertex << " から " << end_vertex
+                      << " への経路の重みが距離の型の範囲を超えました。" << std::endl;
+            return {std::vector<std::string>(), shortest_distance};
+        }
+
         // 経路を復元
         std::vector<std::string> path;
         size_t u = start_index;
@@ -225,6 +241,9 @@ public:
     }
 };
 
+// これまでどおり double の重みと距離を使うグラフ
+typedef BasicGraphData<double> GraphData;
+
 // ヒューリスティック関数 (この例では常に0、ダイクストラ法と同じ)
 double dummy_heuristic(const std::string& u, const std::string& v) {
     // u と v の間に何らかの推定距離を計算する関数
@@ -348,6 +367,31 @@ int main() {
     std::cout << "経路" << input.first << "-" << input.second << " の最短経路は " 
               << path_to_string(shortest_path.first) << " (重み: " << shortest_path.second << ")" << std::endl;
 
+    // 整数の重みと距離 (距離行列のメモリは double の半分)
+    BasicGraphData<int> int_graph;
+    int_graph.add_edge("A", "B", 4);
+    int_graph.add_edge("B", "C", 3);
+    int_graph.add_edge("A", "C", 9);
+    int_graph.add_vertex("D");
+    auto int_path = int_graph.get_shortest_path("A", "C", nullptr);
+    std::cout << "\nint の重み: 経路A-C の最短経路は " << path_to_string(int_path.first)
+              << " (重み: " << int_path.second << ")" << std::endl;
+    int_path = int_graph.get_shortest_path("A", "D", nullptr);
+    std::cout << "int の重み: 経路A-D の最短経路は " << path_to_string(int_path.first)
+              << " (重み: " << int_path.second << ")" << std::endl;
+
+    // 距離が型の範囲を超える場合は、誤った距離を返さずにエラーになる
+    BasicGraphData<unsigned short> short_graph;
+    short_graph.add_edge("A", "B", 40000);
+    short_graph.add_edge("B", "C", 40000);
+    auto short_path = short_graph.get_shortest_path("A", "C", nullptr);
+    std::cout << "unsigned short の重み: 経路A-C (重み 40000 の辺2本) は ";
+    if (CheckedArithmetic<unsigned short>::is_overflow(short_path.second)) {
+        std::cout << "距離が unsigned short の範囲を超えました。" << std::endl;
+    } else {
+        std::cout << path_to_string(short_path.first) << " (重み: " << short_path.second << ")" << std::endl;
+    }
+
     std::cout << "\nWarshallFloyd <----- end" << std::endl;
     
     return 0;